@@ -14,27 +14,40 @@ INCLUDEPATH += .
 #DEFINES += QT_DISABLE_DEPRECATED_UP_TO=0x060000 # disables all APIs deprecated in Qt 6.0.0 and earlier
 
 # Input
-HEADERS += chessgamefilesdata.h \
+HEADERS += arena.h \
+           bitboard.h \
+           chessgamefilesdata.h \
            chessgametabdialog.h \
            chessgamewindow.h \
            chessposition.h \
            chessqsettings.h \
            chesstabhost.h \
+           compactgame.h \
            databasefilter.h \
+           databasefilterplan.h \
            databasefilterproxymodel.h \
            databaselibrary.h \
+           databasesortkeys.h \
            databaseuploader.h \
            databaseviewer.h \
            databaseviewermodel.h \
            enginelinewidget.h \
+           fastchessposition.h \
+           headerstore.h \
            helpers.h \
            mainwindow.h \
            notation.h \
            notationviewer.h \
            openingviewer.h \
+           parallel.h \
+           perft.h \
+           pgnfile.h \
            pgngame.h \
+           pgnindex.h \
            pgnsavedialog.h \
+           pgntokenizer.h \
            pgnuploader.h \
+           positionviewer.h \
            settingsdialog.h \
            streamparser.h \
            tabledelegate.h \
@@ -51,28 +64,40 @@ FORMS += databasefilter.ui \
          databaseuploader.ui \
          pgnuploader.ui
 
-SOURCES += chessgamefilesdata.cpp \
+SOURCES += bitboard.cpp \
+           chessgamefilesdata.cpp \
            chessgametabdialog.cpp \
            chessgamewindow.cpp \
            chessposition.cpp \
            chessqsettings.cpp \
            chesstabhost.cpp \
+           compactgame.cpp \
            databasefilter.cpp \
+           databasefilterplan.cpp \
            databasefilterproxymodel.cpp \
            databaselibrary.cpp \
+           databasesortkeys.cpp \
            databaseuploader.cpp \
            databaseviewer.cpp \
            databaseviewermodel.cpp \
            enginelinewidget.cpp \
+           fastchessposition.cpp \
+           headerstore.cpp \
            helpers.cpp \
            main.cpp \
            mainwindow.cpp \
            notation.cpp \
            notationviewer.cpp \
            openingviewer.cpp \
+           perft.cpp \
+           perftnotation.cpp \
+           pgnfile.cpp \
            pgngame.cpp \
+           pgnindex.cpp \
            pgnsavedialog.cpp \
+           pgntokenizer.cpp \
            pgnuploader.cpp \
+           positionviewer.cpp \
            settingsdialog.cpp \
            streamparser.cpp \
            tabledelegate.cpp \
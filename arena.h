@@ -0,0 +1,59 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QtGlobal>
+
+#include <new>
+#include <utility>
+#include <vector>
+
+// Bump allocator for objects of one type. Objects are constructed in place in chunks that grow
+// geometrically and are never freed one by one; the pool destroys all of them at once
+template <typename T>
+class ArenaPool
+{
+public:
+    ArenaPool() = default;
+    ArenaPool(const ArenaPool &) = delete;
+    ArenaPool &operator=(const ArenaPool &) = delete;
+
+    ~ArenaPool()
+    {
+        for (Chunk &chunk : m_chunks) {
+            for (int i = 0; i < chunk.used; i++) chunk.objects[i].~T();
+            ::operator delete(static_cast<void*>(chunk.objects));
+        }
+    }
+
+    template <typename... Args>
+    T *create(Args&&... args)
+    {
+        if (m_chunks.empty() || m_chunks.back().used == m_chunks.back().capacity) grow();
+        Chunk &chunk = m_chunks.back();
+        T *object = new (chunk.objects + chunk.used) T(std::forward<Args>(args)...);
+        chunk.used++;
+        return object;
+    }
+
+private:
+    struct Chunk {
+        T *objects;
+        int used;
+        int capacity;
+    };
+
+    // starts small so single move trees stay cheap, large games reach the maximum quickly
+    void grow()
+    {
+        int capacity = m_chunks.empty() ? 4 : qMin(m_chunks.back().capacity * 2, 256);
+        m_chunks.push_back({static_cast<T*>(::operator new(sizeof(T) * capacity)), 0, capacity});
+    }
+
+    std::vector<Chunk> m_chunks;
+};
+
+#endif // ARENA_H
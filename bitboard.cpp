@@ -0,0 +1,729 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "bitboard.h"
+
+#include <cstring>
+
+quint64 ZOBRIST_PIECE[12][64];
+quint64 ZOBRIST_CASTLING[16];
+quint64 ZOBRIST_EN_PASSANT_FILE[8];
+quint64 ZOBRIST_SIDE_TO_MOVE = 0;
+
+Bitboard BETWEEN[64][64];
+Bitboard LINE[64][64];
+
+// Sliding rays from each square: north, south, east, west, north-east, north-west, south-east, south-west
+static Bitboard RAYS[8][64];
+static const int RAY_DIRS[8][2] = {{-1,0},{1,0},{0,1},{0,-1},{-1,1},{-1,-1},{1,1},{1,-1}};
+enum RayDirection { NORTH, SOUTH, EAST, WEST, NORTH_EAST, NORTH_WEST, SOUTH_EAST, SOUTH_WEST };
+
+// Rays pointing towards higher square indices find their first blocker with lsb, the rest with msb.
+// Only used to fill the slider tables below.
+static inline Bitboard rayAttacks(int sq, Bitboard occupied, int dir, bool increasing)
+{
+    Bitboard attacks = RAYS[dir][sq];
+    Bitboard blockers = attacks & occupied;
+    if (blockers) attacks ^= RAYS[dir][increasing ? lsb(blockers) : msb(blockers)];
+    return attacks;
+}
+
+static Bitboard slowBishopAttacks(int sq, Bitboard occupied)
+{
+    return rayAttacks(sq, occupied, NORTH_EAST, false) | rayAttacks(sq, occupied, NORTH_WEST, false)
+           | rayAttacks(sq, occupied, SOUTH_EAST, true) | rayAttacks(sq, occupied, SOUTH_WEST, true);
+}
+
+static Bitboard slowRookAttacks(int sq, Bitboard occupied)
+{
+    return rayAttacks(sq, occupied, NORTH, false) | rayAttacks(sq, occupied, WEST, false)
+           | rayAttacks(sq, occupied, SOUTH, true) | rayAttacks(sq, occupied, EAST, true);
+}
+
+// Magic multipliers for this square layout (a8 = 0), searched offline so startup does no search.
+// Each maps the relevant occupancy of a square onto a collision-free index of popCount(mask) bits.
+static const Bitboard ROOK_MAGICS[64] = {
+    0x1080004008801020ULL, 0x0840092002c03000ULL, 0x1900200010400900ULL, 0x0880100008000480ULL,
+    0x4200100420080200ULL, 0x8100020100080400ULL, 0x0200040110886200ULL, 0x0200008040220411ULL,
+    0x0404800084400220ULL, 0x0000401000402000ULL, 0x0086001081220440ULL, 0x0408800800100280ULL,
+    0x000a001201040820ULL, 0x8848800200840080ULL, 0x4001000100040200ULL, 0x0442000102105084ULL,
+    0x9080010020804100ULL, 0x0040404000201009ULL, 0x0000808010002009ULL, 0x2200090021d00100ULL,
+    0x0008008008040080ULL, 0x0004004002010040ULL, 0x0011040008015042ULL, 0x00000a0001768104ULL,
+    0x0000800080204009ULL, 0x2010004140002001ULL, 0x9800200280100080ULL, 0x1000100080080080ULL,
+    0x0442000a00049020ULL, 0x2100040080020080ULL, 0x0800120400900148ULL, 0x0010040a00128541ULL,
+    0x2800804000800030ULL, 0x1010002000400041ULL, 0x4000200011004100ULL, 0x0610008410800800ULL,
+    0x0400802402800800ULL, 0xc100020080800400ULL, 0x0002000802000401ULL, 0x0182085882000401ULL,
+    0x0220204000808000ULL, 0x2860100040024022ULL, 0x0001002004110040ULL, 0x99101042000a0020ULL,
+    0x0004080004008080ULL, 0x0010040002008080ULL, 0x2012004881020004ULL, 0x8300842444820011ULL,
+    0x0088403882010200ULL, 0x0820400080210100ULL, 0x0110910040a00300ULL, 0x0801100280080480ULL,
+    0x0242009008200600ULL, 0x1002000489500200ULL, 0x0040800200010080ULL, 0x0091800041000080ULL,
+    0x0000209300488001ULL, 0x04c1002414824001ULL, 0x020020000b001041ULL, 0x7000100004200901ULL,
+    0x8002002004100802ULL, 0x30010002084c0007ULL, 0x0888221800813004ULL, 0x4000002840840112ULL,
+};
+static const Bitboard BISHOP_MAGICS[64] = {
+    0xa010041108003100ULL, 0x006082020a002900ULL, 0x6810010619200000ULL, 0x08281a0520000408ULL,
+    0x0001104001000400ULL, 0x0018901008048400ULL, 0x00040a0210245280ULL, 0x000200210808a402ULL,
+    0x9140048410821200ULL, 0x0800091010820041ULL, 0x20504804832202c0ULL, 0x0100091401081000ULL,
+    0x8021011140000012ULL, 0x0810020804450400ULL, 0x208b0542109008a2ULL, 0x0080084a08040204ULL,
+    0x0040e2a80811244cULL, 0x2505022008008108ULL, 0x0430220100420040ULL, 0x010a040420220040ULL,
+    0x1105000290400000ULL, 0x0093001200822120ULL, 0x4000a62048043004ULL, 0x280120048a015004ULL,
+    0x006090002a020814ULL, 0x44042000240800d0ULL, 0x01102800040a4400ULL, 0x1004080080220040ULL,
+    0x0001001011004024ULL, 0x0010044000805040ULL, 0x0914041200820100ULL, 0x0004821012821480ULL,
+    0x0024040500c05021ULL, 0x0088611002080200ULL, 0x0116080a00040020ULL, 0x4000020080080080ULL,
+    0x2450450140840040ULL, 0x0000880201484100ULL, 0x0222020404020092ULL, 0x8081110600002e00ULL,
+    0x2842101105000801ULL, 0x1100809008001025ULL, 0x00020202221c0400ULL, 0x0422014022009020ULL,
+    0x0210046102100c00ULL, 0xc004008082029102ULL, 0x00aa461801101200ULL, 0x0404080080201108ULL,
+    0x020542108c205002ULL, 0x0410544804100100ULL, 0x0040910841100000ULL, 0x0400200042021100ULL,
+    0x00004204850400c0ULL, 0x0200100410a42102ULL, 0x1040020801210102ULL, 0x0805040410420000ULL,
+    0x2884804130100200ULL, 0x800c262201242000ULL, 0x1058000194108800ULL, 0x0014221054420204ULL,
+    0x0104000012a02200ULL, 0x0200881003300100ULL, 0x0140400202840100ULL, 0x0402020801010201ULL,
+};
+
+// Relevant occupancy mask, magic and slice of the shared attack table for one square
+struct SliderMagic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard *attacks;
+    int shift;
+};
+
+static SliderMagic ROOK_TABLE[64];
+static SliderMagic BISHOP_TABLE[64];
+// 102400 rook entries followed by 5248 bishop entries
+static Bitboard SLIDER_ATTACKS[102400 + 5248];
+
+// BMI2 PEXT gathers the masked occupancy bits into a dense index directly. It is picked at
+// runtime so one binary runs everywhere; both paths share SLIDER_ATTACKS, which is filled in
+// the index order of whichever path is active.
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define BITBOARD_HAS_PEXT
+#include <immintrin.h>
+
+static bool s_usePext = false;
+
+__attribute__((target("bmi2"))) static quint64 pextIndex(Bitboard occupied, Bitboard mask)
+{
+    return _pext_u64(occupied, mask);
+}
+#endif
+
+static inline quint64 sliderIndex(const SliderMagic &m, Bitboard occupied)
+{
+#ifdef BITBOARD_HAS_PEXT
+    if (s_usePext) return pextIndex(occupied, m.mask);
+#endif
+    return ((occupied & m.mask) * m.magic) >> m.shift;
+}
+
+Bitboard bishopAttacks(int sq, Bitboard occupied)
+{
+    const SliderMagic &m = BISHOP_TABLE[sq];
+    return m.attacks[sliderIndex(m, occupied)];
+}
+
+Bitboard rookAttacks(int sq, Bitboard occupied)
+{
+    const SliderMagic &m = ROOK_TABLE[sq];
+    return m.attacks[sliderIndex(m, occupied)];
+}
+
+// Board edges never block a slider, so they are left out of the relevant occupancy
+static Bitboard relevantMask(int sq, const int *dirs)
+{
+    Bitboard mask = 0;
+    for (int i = 0; i < 4; i++) {
+        Bitboard ray = RAYS[dirs[i]][sq];
+        if (ray) mask |= ray & ~squareBit(dirs[i] == SOUTH || dirs[i] == EAST || dirs[i] >= SOUTH_EAST ? msb(ray) : lsb(ray));
+    }
+    return mask;
+}
+
+static Bitboard *initSliderTable(SliderMagic *table, const Bitboard *magics, const int *dirs,
+                                 Bitboard (*slowAttacks)(int, Bitboard), Bitboard *next)
+{
+    for (int sq = 0; sq < 64; sq++) {
+        SliderMagic &m = table[sq];
+        m.mask = relevantMask(sq, dirs);
+        m.magic = magics[sq];
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = next;
+
+        // Enumerate every subset of the mask (carry-rippler) and store its attack set
+        Bitboard subset = 0;
+        do {
+            m.attacks[sliderIndex(m, subset)] = slowAttacks(sq, subset);
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+        next += 1ULL << popCount(m.mask);
+    }
+    return next;
+}
+
+static void initSliderTables()
+{
+#ifdef BITBOARD_HAS_PEXT
+    s_usePext = __builtin_cpu_supports("bmi2");
+#endif
+    static const int rookDirs[4] = {NORTH, SOUTH, EAST, WEST};
+    static const int bishopDirs[4] = {NORTH_EAST, NORTH_WEST, SOUTH_EAST, SOUTH_WEST};
+    Bitboard *next = initSliderTable(ROOK_TABLE, ROOK_MAGICS, rookDirs, slowRookAttacks, SLIDER_ATTACKS);
+    next = initSliderTable(BISHOP_TABLE, BISHOP_MAGICS, bishopDirs, slowBishopAttacks, next);
+    Q_ASSERT(next == SLIDER_ATTACKS + sizeof(SLIDER_ATTACKS) / sizeof(Bitboard));
+}
+
+void initAttackTables()
+{
+    for (int sq = 0; sq < 64; sq++) {
+        for (int dir = 0; dir < 8; dir++) {
+            RAYS[dir][sq] = 0;
+            int r = rowOf(sq) + RAY_DIRS[dir][0], c = colOf(sq) + RAY_DIRS[dir][1];
+            while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+                RAYS[dir][sq] |= squareBit(squareOf(r, c));
+                r += RAY_DIRS[dir][0]; c += RAY_DIRS[dir][1];
+            }
+        }
+    }
+
+    // Directions come in opposite pairs (0,1), (2,3), (4,5) vs (6,7)
+    static const int OPPOSITE[8] = {SOUTH, NORTH, WEST, EAST, SOUTH_WEST, SOUTH_EAST, NORTH_WEST, NORTH_EAST};
+    std::memset(BETWEEN, 0, sizeof(BETWEEN));
+    std::memset(LINE, 0, sizeof(LINE));
+    for (int a = 0; a < 64; a++) {
+        for (int dir = 0; dir < 8; dir++) {
+            Bitboard ray = RAYS[dir][a];
+            while (ray) {
+                int b = popLsb(ray);
+                BETWEEN[a][b] = RAYS[dir][a] & RAYS[OPPOSITE[dir]][b];
+                LINE[a][b] = RAYS[dir][a] | RAYS[OPPOSITE[dir]][a] | squareBit(a);
+            }
+        }
+    }
+
+    initSliderTables();
+}
+
+void BitboardPosition::clear()
+{
+    std::memset(pieces, 0, sizeof(pieces));
+    occupancy[WHITE] = occupancy[BLACK] = 0;
+    occupied = 0;
+    std::memset(board, NO_PIECE, sizeof(board));
+    sideToMove = WHITE;
+    castling = 0;
+    epSquare = NO_SQUARE;
+    halfmoveClock = 0;
+    fullmoveNumber = 1;
+    key = computeHash();
+}
+
+void BitboardPosition::setStartPosition()
+{
+    static const quint8 backRank[8] = {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK};
+    clear();
+    for (int c = 0; c < 8; c++) {
+        putPiece(squareOf(0, c), makePiece(BLACK, backRank[c]));
+        putPiece(squareOf(1, c), B_PAWN);
+        putPiece(squareOf(6, c), W_PAWN);
+        putPiece(squareOf(7, c), makePiece(WHITE, backRank[c]));
+    }
+    castling = ALL_CASTLING;
+    key = computeHash();
+}
+
+static int pieceFromFenChar(char ch)
+{
+    switch (ch | 0x20) {
+    case 'p': return PAWN;
+    case 'n': return KNIGHT;
+    case 'b': return BISHOP;
+    case 'r': return ROOK;
+    case 'q': return QUEEN;
+    case 'k': return KING;
+    default: return NO_PIECE;
+    }
+}
+
+bool BitboardPosition::setFen(std::string_view fen)
+{
+    clear();
+    const size_t n = fen.size();
+    size_t i = 0;
+    while (i < n && fen[i] == ' ') i++;
+
+    // Placement: exactly eight ranks of eight squares
+    int row = 0, col = 0;
+    for (; i < n && fen[i] != ' '; i++) {
+        char ch = fen[i];
+        if (ch == '/') {
+            if (col != 8 || ++row > 7) break;
+            col = 0;
+        } else if (ch >= '1' && ch <= '8') {
+            col += ch - '0';
+            if (col > 8) break;
+        } else {
+            int piece = pieceFromFenChar(ch);
+            if (piece == NO_PIECE || col > 7) break;
+            putPiece(squareOf(row, col), makePiece(ch >= 'a' ? BLACK : WHITE, piece));
+            col++;
+        }
+    }
+    if ((i < n && fen[i] != ' ') || row != 7 || col != 8) {
+        clear();
+        return false;
+    }
+
+    while (i < n && fen[i] == ' ') i++;
+    if (i < n && fen[i] == 'b') sideToMove = BLACK;
+    if (i < n) i++;
+
+    while (i < n && fen[i] == ' ') i++;
+    for (; i < n && fen[i] != ' '; i++) {
+        if (fen[i] == 'K') castling |= WHITE_KING_SIDE;
+        if (fen[i] == 'Q') castling |= WHITE_QUEEN_SIDE;
+        if (fen[i] == 'k') castling |= BLACK_KING_SIDE;
+        if (fen[i] == 'q') castling |= BLACK_QUEEN_SIDE;
+    }
+
+    while (i < n && fen[i] == ' ') i++;
+    if (i + 1 < n && fen[i] >= 'a' && fen[i] <= 'h' && fen[i+1] >= '1' && fen[i+1] <= '8') {
+        epSquare = squareOf(8 - (fen[i+1] - '0'), fen[i] - 'a');
+        i += 2;
+    } else if (i < n) {
+        i++;
+    }
+
+    int clocks[2] = {0, 1};
+    for (int c = 0; c < 2; c++) {
+        while (i < n && fen[i] == ' ') i++;
+        if (i >= n || fen[i] < '0' || fen[i] > '9') break;
+        clocks[c] = 0;
+        for (; i < n && fen[i] >= '0' && fen[i] <= '9'; i++) clocks[c] = qMin(clocks[c] * 10 + (fen[i] - '0'), 65535);
+    }
+    halfmoveClock = clocks[0];
+    fullmoveNumber = clocks[1];
+
+    key = computeHash();
+    return true;
+}
+
+static char *writeNumber(char *out, unsigned value)
+{
+    char digits[10];
+    int count = 0;
+    do {
+        digits[count++] = char('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (count) *out++ = digits[--count];
+    return out;
+}
+
+int BitboardPosition::writeFen(char *buffer, bool withClocks) const
+{
+    static const char PIECE_CHARS[] = "PNBRQKpnbrqk";
+    char *out = buffer;
+    for (int row = 0; row < 8; row++) {
+        int empty = 0;
+        for (int col = 0; col < 8; col++) {
+            int piece = board[squareOf(row, col)];
+            if (piece == NO_PIECE) {
+                empty++;
+                continue;
+            }
+            if (empty) *out++ = char('0' + empty);
+            empty = 0;
+            *out++ = PIECE_CHARS[piece];
+        }
+        if (empty) *out++ = char('0' + empty);
+        if (row < 7) *out++ = '/';
+    }
+
+    *out++ = ' ';
+    *out++ = (sideToMove == WHITE ? 'w' : 'b');
+
+    *out++ = ' ';
+    if (!castling) *out++ = '-';
+    if (castling & WHITE_KING_SIDE) *out++ = 'K';
+    if (castling & WHITE_QUEEN_SIDE) *out++ = 'Q';
+    if (castling & BLACK_KING_SIDE) *out++ = 'k';
+    if (castling & BLACK_QUEEN_SIDE) *out++ = 'q';
+
+    *out++ = ' ';
+    if (epSquare == NO_SQUARE) {
+        *out++ = '-';
+    } else {
+        *out++ = char('a' + colOf(epSquare));
+        *out++ = char('8' - rowOf(epSquare));
+    }
+
+    if (withClocks) {
+        *out++ = ' ';
+        out = writeNumber(out, halfmoveClock);
+        *out++ = ' ';
+        out = writeNumber(out, fullmoveNumber);
+    }
+    *out = '\0';
+    return int(out - buffer);
+}
+
+int BitboardPosition::kingSquare(int color) const
+{
+    Bitboard kings = pieces[makePiece(color, KING)];
+    return kings ? lsb(kings) : -1;
+}
+
+void BitboardPosition::putPiece(int sq, int piece)
+{
+    Bitboard bit = squareBit(sq);
+    pieces[piece] |= bit;
+    occupancy[pieceColor(piece)] |= bit;
+    occupied |= bit;
+    board[sq] = piece;
+    key ^= ZOBRIST_PIECE[piece][sq];
+}
+
+void BitboardPosition::removePiece(int sq)
+{
+    int piece = board[sq];
+    if (piece == NO_PIECE) return;
+    Bitboard bit = squareBit(sq);
+    pieces[piece] &= ~bit;
+    occupancy[pieceColor(piece)] &= ~bit;
+    occupied &= ~bit;
+    board[sq] = NO_PIECE;
+    key ^= ZOBRIST_PIECE[piece][sq];
+}
+
+void BitboardPosition::movePiece(int from, int to)
+{
+    int piece = board[from];
+    Bitboard fromTo = squareBit(from) | squareBit(to);
+    pieces[piece] ^= fromTo;
+    occupancy[pieceColor(piece)] ^= fromTo;
+    occupied ^= fromTo;
+    board[to] = piece;
+    board[from] = NO_PIECE;
+    key ^= ZOBRIST_PIECE[piece][from] ^ ZOBRIST_PIECE[piece][to];
+}
+
+void BitboardPosition::relocatePiece(int from, int to)
+{
+    if (board[from] == NO_PIECE || from == to) return;
+    removePiece(to);
+    movePiece(from, to);
+}
+
+void BitboardPosition::applyMove(int from, int to, int promoType)
+{
+    UndoInfo undo;
+    makeMove(encodeMove(from, to, promoType < 0 ? PAWN : promoType), undo);
+}
+
+void BitboardPosition::makeMove(Move move, UndoInfo &undo)
+{
+    int from = moveFrom(move), to = moveTo(move);
+    int piece = board[from];
+    int captured = board[to];
+
+    undo.key = key;
+    undo.halfmoveClock = halfmoveClock;
+    undo.captured = captured;
+    undo.castling = castling;
+    undo.epSquare = epSquare;
+    if (piece == NO_PIECE) return;
+
+    int color = pieceColor(piece);
+    int type = pieceType(piece);
+
+    // Castling and en passant keys are xored out here and back in once the new state is known
+    key ^= ZOBRIST_CASTLING[castling];
+    if (epSquare != NO_SQUARE) key ^= ZOBRIST_EN_PASSANT_FILE[colOf(epSquare)];
+
+    // Update castling rights if king or rook moves
+    if (type == KING) {
+        castling &= (color == WHITE ? ~(WHITE_KING_SIDE | WHITE_QUEEN_SIDE) : ~(BLACK_KING_SIDE | BLACK_QUEEN_SIDE));
+        // Rook relocation during castling
+        int row = rowOf(from);
+        if (colOf(from) - colOf(to) == 2) movePiece(squareOf(row, 0), squareOf(row, colOf(from) - 1));
+        if (colOf(from) - colOf(to) == -2) movePiece(squareOf(row, 7), squareOf(row, colOf(from) + 1));
+    } else if (type == ROOK) {
+        if (from == squareOf(7, 0)) castling &= ~WHITE_QUEEN_SIDE;
+        if (from == squareOf(7, 7)) castling &= ~WHITE_KING_SIDE;
+        if (from == squareOf(0, 0)) castling &= ~BLACK_QUEEN_SIDE;
+        if (from == squareOf(0, 7)) castling &= ~BLACK_KING_SIDE;
+    }
+    // Capture affects opponent rook rights
+    if (captured != NO_PIECE && pieceType(captured) == ROOK) {
+        if (to == squareOf(7, 0)) castling &= ~WHITE_QUEEN_SIDE;
+        if (to == squareOf(7, 7)) castling &= ~WHITE_KING_SIDE;
+        if (to == squareOf(0, 0)) castling &= ~BLACK_QUEEN_SIDE;
+        if (to == squareOf(0, 7)) castling &= ~BLACK_KING_SIDE;
+    }
+
+    // En passant capture
+    if (type == PAWN && captured == NO_PIECE && to == epSquare && colOf(from) != colOf(to)) {
+        removePiece(squareOf(rowOf(from), colOf(to)));
+    }
+
+    // Perform move
+    removePiece(to);
+    movePiece(from, to);
+
+    // Pawn double move: set en passant target
+    if (type == PAWN && qAbs(rowOf(to) - rowOf(from)) == 2) {
+        epSquare = (from + to) / 2;
+    } else {
+        epSquare = NO_SQUARE;
+    }
+    // Promotion
+    int promoType = movePromotion(move);
+    if (promoType > PAWN && promoType < KING && type == PAWN && (rowOf(to) == 0 || rowOf(to) == 7)) {
+        removePiece(to);
+        putPiece(to, makePiece(color, promoType));
+    }
+
+    if (type == PAWN || captured != NO_PIECE) halfmoveClock = 0;
+    else halfmoveClock++;
+    fullmoveNumber += (sideToMove == BLACK);
+    sideToMove ^= 1;
+
+    key ^= ZOBRIST_CASTLING[castling] ^ ZOBRIST_SIDE_TO_MOVE;
+    if (epSquare != NO_SQUARE) key ^= ZOBRIST_EN_PASSANT_FILE[colOf(epSquare)];
+    Q_ASSERT_X(key == computeHash(), "BitboardPosition::makeMove", "incremental zobrist key out of sync");
+}
+
+void BitboardPosition::unmakeMove(Move move, const UndoInfo &undo)
+{
+    int from = moveFrom(move), to = moveTo(move);
+    int piece = board[to];
+    if (piece == NO_PIECE) return;
+
+    sideToMove ^= 1;
+    fullmoveNumber -= (sideToMove == BLACK);
+    int color = pieceColor(piece);
+
+    int promoType = movePromotion(move);
+    if (promoType > PAWN && promoType < KING && pieceType(piece) == promoType && (rowOf(to) == 0 || rowOf(to) == 7)) {
+        removePiece(to);
+        putPiece(from, makePiece(color, PAWN));
+    } else {
+        movePiece(to, from);
+    }
+
+    if (undo.captured != NO_PIECE) {
+        putPiece(to, undo.captured);
+    } else if (pieceType(piece) == PAWN && to == undo.epSquare && colOf(from) != colOf(to)) {
+        putPiece(squareOf(rowOf(from), colOf(to)), makePiece(color ^ 1, PAWN));
+    }
+
+    // Put the rook back after castling
+    if (pieceType(piece) == KING) {
+        int row = rowOf(from);
+        if (colOf(from) - colOf(to) == 2) movePiece(squareOf(row, colOf(from) - 1), squareOf(row, 0));
+        if (colOf(from) - colOf(to) == -2) movePiece(squareOf(row, colOf(from) + 1), squareOf(row, 7));
+    }
+
+    castling = undo.castling;
+    epSquare = undo.epSquare;
+    halfmoveClock = undo.halfmoveClock;
+    key = undo.key;
+}
+
+bool BitboardPosition::leavesKingInCheck(int from, int to) const
+{
+    int piece = board[from];
+    if (piece == NO_PIECE) return false;
+    int color = pieceColor(piece);
+
+    Bitboard removed = squareBit(to) & occupancy[color ^ 1];
+    if (pieceType(piece) == PAWN && to == epSquare && board[to] == NO_PIECE && colOf(from) != colOf(to)) {
+        removed = squareBit(squareOf(rowOf(from), colOf(to)));
+    }
+    Bitboard occupiedAfter = (occupied ^ squareBit(from) ^ removed) | squareBit(to);
+
+    int king = (pieceType(piece) == KING ? to : kingSquare(color));
+    if (king < 0) return false;
+    return attackersTo(king, occupiedAfter) & occupancy[color ^ 1] & ~removed;
+}
+
+Bitboard BitboardPosition::attackersTo(int sq, Bitboard occupiedMask) const
+{
+    return (PAWN_ATTACKS[BLACK][sq] & pieces[W_PAWN])
+           | (PAWN_ATTACKS[WHITE][sq] & pieces[B_PAWN])
+           | (KNIGHT_ATTACKS[sq] & (pieces[W_KNIGHT] | pieces[B_KNIGHT]))
+           | (KING_ATTACKS[sq] & (pieces[W_KING] | pieces[B_KING]))
+           | (bishopAttacks(sq, occupiedMask) & (pieces[W_BISHOP] | pieces[B_BISHOP] | pieces[W_QUEEN] | pieces[B_QUEEN]))
+           | (rookAttacks(sq, occupiedMask) & (pieces[W_ROOK] | pieces[B_ROOK] | pieces[W_QUEEN] | pieces[B_QUEEN]));
+}
+
+bool BitboardPosition::squareAttacked(int sq, int byColor) const
+{
+    return attackersTo(sq, occupied) & occupancy[byColor];
+}
+
+bool BitboardPosition::inCheck(int color) const
+{
+    int king = kingSquare(color);
+    return king >= 0 && squareAttacked(king, color ^ 1);
+}
+
+static inline void addPawnMoves(MoveList &list, int from, int to, bool promotion)
+{
+    if (promotion) {
+        for (int promo = KNIGHT; promo <= QUEEN; promo++) list.add(encodeMove(from, to, promo));
+    } else {
+        list.add(encodeMove(from, to));
+    }
+}
+
+void BitboardPosition::generateLegalMoves(MoveList &list) const
+{
+    const int us = sideToMove, them = sideToMove ^ 1;
+    const Bitboard own = occupancy[us], enemy = occupancy[them];
+    const int king = kingSquare(us);
+
+    Bitboard checkMask = ~0ULL;
+    Bitboard pinned = 0;
+    if (king >= 0) {
+        // King moves are checked against attacks with the king lifted off the board so it cannot hide behind itself
+        Bitboard withoutKing = occupied ^ squareBit(king);
+        Bitboard targets = KING_ATTACKS[king] & ~own;
+        while (targets) {
+            int to = popLsb(targets);
+            if (!(attackersTo(to, withoutKing) & enemy)) list.add(encodeMove(king, to));
+        }
+
+        Bitboard checkers = attackersTo(king, occupied) & enemy;
+        if (popCount(checkers) > 1) return;
+        if (checkers) checkMask = checkers | BETWEEN[king][lsb(checkers)];
+
+        // Pieces alone between the king and an enemy slider may only move along that line
+        Bitboard snipers = (rookAttacks(king, 0) & (pieces[makePiece(them, ROOK)] | pieces[makePiece(them, QUEEN)]))
+                           | (bishopAttacks(king, 0) & (pieces[makePiece(them, BISHOP)] | pieces[makePiece(them, QUEEN)]));
+        while (snipers) {
+            Bitboard blockers = BETWEEN[king][popLsb(snipers)] & occupied;
+            if (blockers && !(blockers & (blockers - 1)) && (blockers & own)) pinned |= blockers;
+        }
+
+        // Castling keeps the existing rules: rights held, path to the rook empty, king path not attacked
+        const int homeRow = (us == WHITE ? 7 : 0);
+        if (!checkers && king == squareOf(homeRow, 4)) {
+            const quint8 kingSide = (us == WHITE ? WHITE_KING_SIDE : BLACK_KING_SIDE);
+            const quint8 queenSide = (us == WHITE ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE);
+            if ((castling & kingSide) && !(BETWEEN[king][squareOf(homeRow, 7)] & occupied)
+                && !squareAttacked(king + 1, them) && !squareAttacked(king + 2, them))
+                list.add(encodeMove(king, king + 2));
+            if ((castling & queenSide) && !(BETWEEN[king][squareOf(homeRow, 0)] & occupied)
+                && !squareAttacked(king - 1, them) && !squareAttacked(king - 2, them))
+                list.add(encodeMove(king, king - 2));
+        }
+    }
+
+    const Bitboard targetMask = ~own & checkMask;
+    for (int type = KNIGHT; type <= QUEEN; type++) {
+        Bitboard movers = pieces[makePiece(us, type)];
+        while (movers) {
+            int from = popLsb(movers);
+            Bitboard targets;
+            switch (type) {
+            case KNIGHT: targets = KNIGHT_ATTACKS[from]; break;
+            case BISHOP: targets = bishopAttacks(from, occupied); break;
+            case ROOK: targets = rookAttacks(from, occupied); break;
+            default: targets = queenAttacks(from, occupied); break;
+            }
+            targets &= targetMask;
+            if (pinned & squareBit(from)) targets &= LINE[king][from];
+            while (targets) list.add(encodeMove(from, popLsb(targets)));
+        }
+    }
+
+    const int forward = (us == WHITE ? -8 : 8);
+    const int startRow = (us == WHITE ? 6 : 1);
+    const int promoRow = (us == WHITE ? 0 : 7);
+    Bitboard pawns = pieces[makePiece(us, PAWN)];
+    while (pawns) {
+        int from = popLsb(pawns);
+        Bitboard allowed = checkMask;
+        if (pinned & squareBit(from)) allowed &= LINE[king][from];
+
+        int to = from + forward;
+        if (!(occupied & squareBit(to))) {
+            if (allowed & squareBit(to)) addPawnMoves(list, from, to, rowOf(to) == promoRow);
+            int twoStep = to + forward;
+            if (rowOf(from) == startRow && !(occupied & squareBit(twoStep)) && (allowed & squareBit(twoStep)))
+                list.add(encodeMove(from, twoStep));
+        }
+
+        Bitboard captures = PAWN_ATTACKS[us][from] & enemy & allowed;
+        while (captures) {
+            to = popLsb(captures);
+            addPawnMoves(list, from, to, rowOf(to) == promoRow);
+        }
+
+        // En passant can expose the king along the rank, so it gets a full check test
+        if (epSquare != NO_SQUARE && (PAWN_ATTACKS[us][from] & squareBit(epSquare)) && !leavesKingInCheck(from, epSquare))
+            list.add(encodeMove(from, epSquare));
+    }
+}
+
+quint64 BitboardPosition::perft(int depth)
+{
+    MoveList moves;
+    generateLegalMoves(moves);
+    if (depth <= 1) return depth == 1 ? moves.size() : 1;
+
+    quint64 nodes = 0;
+    for (Move move : moves) {
+        UndoInfo undo;
+        makeMove(move, undo);
+        nodes += perft(depth - 1);
+        unmakeMove(move, undo);
+    }
+    return nodes;
+}
+
+quint64 BitboardPosition::computeHash() const
+{
+    quint64 hash = 0;
+    for (int piece = 0; piece < 12; piece++) {
+        Bitboard b = pieces[piece];
+        while (b) hash ^= ZOBRIST_PIECE[piece][popLsb(b)];
+    }
+    hash ^= ZOBRIST_CASTLING[castling];
+    if (epSquare != NO_SQUARE) hash ^= ZOBRIST_EN_PASSANT_FILE[colOf(epSquare)];
+    if (sideToMove == BLACK) hash ^= ZOBRIST_SIDE_TO_MOVE;
+    return hash;
+}
+
+quint64 BitboardPosition::placementKey(int color) const
+{
+    quint64 hash = key ^ ZOBRIST_CASTLING[castling];
+    if (epSquare != NO_SQUARE) hash ^= ZOBRIST_EN_PASSANT_FILE[colOf(epSquare)];
+    if (color != sideToMove) hash ^= ZOBRIST_SIDE_TO_MOVE;
+    return hash;
+}
+
+// Determinisic pseduo-random number generator for consistent zobrist hashes
+static quint64 splitmix64_next(quint64 &state)
+{
+    state += 0x9E3779B97F4A7C15ull;
+    quint64 z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= (z >> 31);
+    return z;
+}
+
+void initZobristTables()
+{
+    quint64 seed = 0xC0FFEE5EED1234ABull;
+    for (int i = 0; i < 12; i++){
+        for (int j = 0; j < 64; j++) {
+            ZOBRIST_PIECE[i][j] = splitmix64_next(seed);
+        }
+    }
+    for (int i = 0; i < 16; i++) ZOBRIST_CASTLING[i] = splitmix64_next(seed);
+    for (int i = 0; i < 8; i++) ZOBRIST_EN_PASSANT_FILE[i] = splitmix64_next(seed);
+    ZOBRIST_SIDE_TO_MOVE = splitmix64_next(seed);
+}
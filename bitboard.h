@@ -0,0 +1,224 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <QtGlobal>
+
+#include <array>
+#include <string_view>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Squares are indexed row * 8 + col with a8 = 0 and h1 = 63, matching the board rows used by QML
+typedef quint64 Bitboard;
+
+enum PieceColor : quint8 { WHITE = 0, BLACK = 1 };
+enum PieceType : quint8 { PAWN = 0, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+
+// Piece codes double as indices into the zobrist piece table: white pieces 0-5, black pieces 6-11
+enum Piece : quint8 {
+    W_PAWN = 0, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING,
+    B_PAWN, B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN, B_KING,
+    NO_PIECE
+};
+
+// Castling bits follow the zobrist castling mask layout
+enum CastlingFlag : quint8 {
+    BLACK_KING_SIDE = 1,
+    BLACK_QUEEN_SIDE = 2,
+    WHITE_KING_SIDE = 4,
+    WHITE_QUEEN_SIDE = 8,
+    ALL_CASTLING = 15
+};
+
+const quint8 NO_SQUARE = 64;
+
+// Room for the longest FEN record, clocks and terminator included
+const int FEN_BUFFER_SIZE = 128;
+
+constexpr int squareOf(int row, int col) { return row * 8 + col; }
+constexpr int rowOf(int sq) { return sq >> 3; }
+constexpr int colOf(int sq) { return sq & 7; }
+constexpr Bitboard squareBit(int sq) { return 1ULL << sq; }
+
+constexpr int makePiece(int color, int type) { return color * 6 + type; }
+constexpr int pieceColor(int piece) { return piece / 6; }
+constexpr int pieceType(int piece) { return piece % 6; }
+
+inline int popCount(Bitboard b)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<int>(__popcnt64(b));
+#else
+    return __builtin_popcountll(b);
+#endif
+}
+
+inline int lsb(Bitboard b)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, b);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(b);
+#endif
+}
+
+inline int msb(Bitboard b)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse64(&index, b);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(b);
+#endif
+}
+
+inline int popLsb(Bitboard &b)
+{
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+// Moves are packed into 16 bits: from square (6), to square (6), promotion piece type (4, PAWN = none)
+typedef quint16 Move;
+
+inline Move encodeMove(int from, int to, int promoType = PAWN) { return static_cast<Move>(from | (to << 6) | (promoType << 12)); }
+inline int moveFrom(Move move) { return move & 63; }
+inline int moveTo(Move move) { return (move >> 6) & 63; }
+inline int movePromotion(Move move) { return move >> 12; }
+
+// a8a8 can never be played, so the all-zero move doubles as "no move"
+const Move NULL_MOVE = 0;
+
+// Fixed-capacity move buffer meant to live on the stack; no legal position has more than 218 moves
+struct MoveList
+{
+    Move moves[256];
+    int count = 0;
+
+    void add(Move move) { moves[count++] = move; }
+    int size() const { return count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+};
+
+// Knight, king and pawn attacks are built at compile time from (row, col) offsets
+struct LeaperOffset { int dr, dc; };
+
+constexpr std::array<Bitboard, 64> leaperTable(const LeaperOffset *offsets, int count)
+{
+    std::array<Bitboard, 64> table{};
+    for (int sq = 0; sq < 64; sq++) {
+        for (int i = 0; i < count; i++) {
+            int r = rowOf(sq) + offsets[i].dr, c = colOf(sq) + offsets[i].dc;
+            if (r >= 0 && r < 8 && c >= 0 && c < 8) table[sq] |= squareBit(squareOf(r, c));
+        }
+    }
+    return table;
+}
+
+inline constexpr LeaperOffset KNIGHT_OFFSETS[8] = {{2,1},{2,-1},{-2,1},{-2,-1},{1,2},{1,-2},{-1,2},{-1,-2}};
+inline constexpr LeaperOffset KING_OFFSETS[8] = {{-1,-1},{-1,0},{-1,1},{0,-1},{0,1},{1,-1},{1,0},{1,1}};
+// White pawns move towards row 0, black pawns towards row 7
+inline constexpr LeaperOffset PAWN_OFFSETS[2][2] = {{{-1,-1},{-1,1}}, {{1,-1},{1,1}}};
+
+inline constexpr std::array<Bitboard, 64> KNIGHT_ATTACKS = leaperTable(KNIGHT_OFFSETS, 8);
+inline constexpr std::array<Bitboard, 64> KING_ATTACKS = leaperTable(KING_OFFSETS, 8);
+inline constexpr std::array<Bitboard, 64> PAWN_ATTACKS[2] = {leaperTable(PAWN_OFFSETS[WHITE], 2), leaperTable(PAWN_OFFSETS[BLACK], 2)};
+
+static_assert(KNIGHT_ATTACKS[0] == ((1ULL << 10) | (1ULL << 17)), "knight table on a8");
+static_assert(KING_ATTACKS[63] == ((1ULL << 54) | (1ULL << 55) | (1ULL << 62)), "king table on h1");
+
+// Line tables, filled by initAttackTables()
+extern Bitboard BETWEEN[64][64];
+extern Bitboard LINE[64][64];
+
+// Slider attacks are single lookups into magic bitboard tables (PEXT indexed when BMI2 is available)
+Bitboard bishopAttacks(int sq, Bitboard occupied);
+Bitboard rookAttacks(int sq, Bitboard occupied);
+inline Bitboard queenAttacks(int sq, Bitboard occupied) { return bishopAttacks(sq, occupied) | rookAttacks(sq, occupied); }
+
+// State that makeMove cannot recover from the move itself
+struct UndoInfo
+{
+    quint64 key;
+    quint16 halfmoveClock;
+    quint8 captured;
+    quint8 castling;
+    quint8 epSquare;
+};
+
+// Compact board state: one bitboard per piece, occupancy masks and a mailbox for square lookups
+struct BitboardPosition
+{
+    Bitboard pieces[12];
+    Bitboard occupancy[2];
+    Bitboard occupied;
+    quint8 board[64];
+    quint8 sideToMove;
+    quint8 castling;
+    quint8 epSquare;
+    quint16 halfmoveClock;
+    quint16 fullmoveNumber;
+    // Zobrist hash, kept up to date incrementally by the piece primitives and makeMove
+    quint64 key;
+
+    void clear();
+    void setStartPosition();
+    // Loads a FEN record; missing clocks default to "0 1". Returns false and leaves the
+    // position cleared on malformed input
+    bool setFen(std::string_view fen);
+    // Writes the FEN record into buffer (at least FEN_BUFFER_SIZE bytes) and returns its length.
+    // Without clocks only placement, side, castling and en passant are written.
+    int writeFen(char *buffer, bool withClocks = true) const;
+
+    int pieceAt(int sq) const { return board[sq]; }
+    int kingSquare(int color) const;
+    void putPiece(int sq, int piece);
+    void removePiece(int sq);
+    void movePiece(int from, int to);
+
+    // Moves a piece for display purposes only (premoves); no game state is updated
+    void relocatePiece(int from, int to);
+
+    // Plays a move without legality checks; promoType is a PieceType or -1 for none
+    void applyMove(int from, int to, int promoType);
+
+    // In-place move application; a promotion is only honoured for a pawn reaching the last rank
+    void makeMove(Move move, UndoInfo &undo);
+    // Reverts makeMove given the same move and the undo record it filled
+    void unmakeMove(Move move, const UndoInfo &undo);
+
+    // Whether playing a non-castling move would leave the mover's king attacked
+    bool leavesKingInCheck(int from, int to) const;
+
+    // All pieces of either color attacking sq given the occupancy
+    Bitboard attackersTo(int sq, Bitboard occupiedMask) const;
+    bool squareAttacked(int sq, int byColor) const;
+    bool inCheck(int color) const;
+
+    // Fills list with the legal moves for the side to move
+    void generateLegalMoves(MoveList &list) const;
+
+    // Counts leaf nodes of the legal move tree to the given depth
+    quint64 perft(int depth);
+
+    quint64 computeHash() const;
+    // Key of the piece placement with color to move, leaving out castling rights and the en
+    // passant square; games are searched by position with it, as a board set up by hand has neither
+    quint64 placementKey(int color) const;
+};
+
+void initZobristTables();
+void initAttackTables();
+
+#endif // BITBOARD_H
@@ -40,14 +40,14 @@ ChessGameWindow::ChessGameWindow(QWidget *parent, PGNGame game)
 
     // set the chessboard as central widget of window, and link to QML
     QQuickWidget *boardView = new QQuickWidget;
-    m_positionViewer = new ChessPosition(this);
+    m_positionViewer = new PositionViewer(this);
     boardView->setResizeMode(QQuickWidget::SizeRootObjectToView);
     boardView->rootContext()->setContextProperty("chessPosition", m_positionViewer);
     boardView->setSource(QUrl(QStringLiteral("qrc:/chessboard.qml")));
     boardView->setMinimumSize(200, 200);
     setCentralWidget(boardView);
-    connect(m_positionViewer, &ChessPosition::moveMade, this, &ChessGameWindow::onMoveMade);
-    connect(m_positionViewer, &ChessPosition::premoveMade, this, &ChessGameWindow::onPremoveMade);
+    connect(m_positionViewer, &PositionViewer::moveMade, this, &ChessGameWindow::onMoveMade);
+    connect(m_positionViewer, &PositionViewer::premoveMade, this, &ChessGameWindow::onPremoveMade);
 
     // link to the rootmove containing the entire game tree
     m_notationViewer = new NotationViewer(game, this);
@@ -143,7 +143,7 @@ void ChessGameWindow::gameplaySetup()
 
     m_notationDock->hide();
 
-    // create viewer with pointer to the same ChessPosition
+    // create viewer with pointer to the same PositionViewer
     m_gameplayViewer = new GameplayViewer(m_positionViewer, this);
     m_gameplayDock = new QDockWidget(tr("Play vs Engine"), this);
     m_gameplayDock->setContextMenuPolicy(Qt::PreventContextMenu);
@@ -153,8 +153,8 @@ void ChessGameWindow::gameplaySetup()
     addDockWidget(Qt::RightDockWidgetArea, m_gameplayDock);
     m_gameplayDock->show();
 
-    connect(m_positionViewer, &ChessPosition::moveMade, m_gameplayViewer, &GameplayViewer::onBoardMoveMade);
-    connect(m_positionViewer, &ChessPosition::isBoardFlippedChanged, m_gameplayViewer, &GameplayViewer::updateClockDisplays);
+    connect(m_positionViewer, &PositionViewer::moveMade, m_gameplayViewer, &GameplayViewer::onBoardMoveMade);
+    connect(m_positionViewer, &PositionViewer::isBoardFlippedChanged, m_gameplayViewer, &GameplayViewer::updateClockDisplays);
     connect(m_gameplayViewer, &GameplayViewer::selectLastMove, this, &ChessGameWindow::onSelectLastMove);
     connect(m_gameplayViewer, &GameplayViewer::resetBoard, this, &ChessGameWindow::onResetBoard);
     connect(m_gameplayViewer, &GameplayViewer::matchBoardFlip, this, &ChessGameWindow::onMatchBoardFlip);
@@ -551,7 +551,7 @@ void ChessGameWindow::openingSetup()
 
     m_openingViewer = new OpeningViewer(this);
     auto currentMove = m_notationViewer->getSelectedMove();
-    if (!currentMove->m_zobristHash) currentMove->m_zobristHash = currentMove->m_position->computeZobrist();
+    if (!currentMove->m_zobristHash) currentMove->m_zobristHash = currentMove->m_position.computeZobrist();
     m_openingViewer->updatePosition(currentMove->m_zobristHash, currentMove->m_position, currentMove->moveText);
 
     m_openingDock = new QDockWidget(tr("Opening Explorer"), this);
@@ -564,10 +564,9 @@ void ChessGameWindow::openingSetup()
     // update openingViewer when notationViewer changes
     connect(m_notationViewer, &NotationViewer::moveSelected, m_openingViewer, &OpeningViewer::onMoveSelected);
     
-    connect(m_openingViewer, &OpeningViewer::moveClicked, this, [this](const SimpleMove& moveData) {
-        if (!m_notationViewer->getSelectedMove().isNull() && m_notationViewer->getSelectedMove()->m_position) {
-            auto [sr, sc, dr, dc, promo] = moveData;
-            m_positionViewer->buildUserMove(sr, sc, dr, dc, promo);
+    connect(m_openingViewer, &OpeningViewer::moveClicked, this, [this](Move moveData) {
+        if (!m_notationViewer->getSelectedMove().isNull()) {
+            m_positionViewer->buildUserMove(moveData);
         }
     });
 
@@ -658,8 +657,8 @@ void ChessGameWindow::onMatchBoardFlip(QChar side)
 void ChessGameWindow::onSelectLastMove()
 {
     auto curMove =  m_notationViewer->m_selectedMove;
-    while (curMove->m_nextMoves.size()){
-        curMove = curMove->m_nextMoves.front();
+    while (curMove->nextMoves().size()){
+        curMove = curMove->nextMoves().front();
     }
     m_notationViewer->m_selectedMove = curMove;
     emit m_notationViewer->moveSelected(curMove);
@@ -669,11 +668,11 @@ void ChessGameWindow::onSelectLastMove()
 void ChessGameWindow::onRequestTakeback(QChar side)
 {
     auto curMove = m_notationViewer->m_selectedMove;
-    if (!curMove->m_previousMove.toStrongRef()) return;
-    while (curMove->m_nextMoves.size()){
-        curMove = curMove->m_nextMoves.front();
+    if (!curMove->m_previousMove) return;
+    while (curMove->nextMoves().size()){
+        curMove = curMove->nextMoves().front();
     }
-    curMove = curMove->m_previousMove.toStrongRef()->m_previousMove.toStrongRef();
+    curMove = curMove->m_previousMove->m_previousMove;
     deleteSubtree(curMove);
     emit m_notationViewer->moveSelected(curMove);
     m_notationViewer->refresh();
@@ -684,33 +683,33 @@ void ChessGameWindow::onEvalScoreChanged(double evalScore)
     m_positionViewer->setEvalScore(evalScore);
 }
 
-void ChessGameWindow::onMoveHovered(QSharedPointer<NotationMove>& move)
+void ChessGameWindow::onMoveHovered(NotationMovePtr& move)
 {
     // preview position of move
-    m_positionViewer->copyFrom(*move->m_position);
+    m_positionViewer->setPosition(move->m_position);
     emit m_positionViewer->boardDataChanged();
     emit m_positionViewer->lastMoveChanged();
     m_positionViewer->setIsPreview(true);
-    m_positionViewer->copyFrom(*move->m_position);
+    m_positionViewer->setPosition(move->m_position);
     emit m_positionViewer->boardDataChanged();
 }
 
 void ChessGameWindow::onNoHover(){
     // no hover, revert to the currently selected move’s position
-    m_positionViewer->copyFrom(*m_notationViewer->getSelectedMove()->m_position);
+    m_positionViewer->setPosition(m_notationViewer->getSelectedMove()->m_position);
     emit m_positionViewer->boardDataChanged();
     emit m_positionViewer->lastMoveChanged();
     m_positionViewer->setIsPreview(false);
-    QSharedPointer<NotationMove> selectedMove = m_notationViewer->getSelectedMove();
-    if (!selectedMove.isNull()) m_positionViewer->copyFrom(*selectedMove->m_position);
+    NotationMovePtr selectedMove = m_notationViewer->getSelectedMove();
+    if (!selectedMove.isNull()) m_positionViewer->setPosition(selectedMove->m_position);
     emit m_positionViewer->boardDataChanged();
 }
 
 // Slot for when a new move is made on the board
-void ChessGameWindow::onMoveMade(QSharedPointer<NotationMove>& move)
+void ChessGameWindow::onMoveMade(NotationMovePtr& move)
 {
     if (m_isGameplay){
-        bool isLastMove = !m_notationViewer->m_selectedMove->m_nextMoves.size();
+        bool isLastMove = !m_notationViewer->m_selectedMove->nextMoves().size();
         if (!isLastMove) {
             onSelectLastMove();
             return;
@@ -722,7 +721,7 @@ void ChessGameWindow::onMoveMade(QSharedPointer<NotationMove>& move)
     // link move if unique
     if (child == move){
         m_notationViewer->m_isEdited = true;
-        linkMoves(m_notationViewer->m_selectedMove, move);
+        child = linkMoves(m_notationViewer->m_selectedMove, move);
     }
     m_notationViewer->m_selectedMove = child;
     emit m_notationViewer->moveSelected(m_notationViewer->m_selectedMove);
@@ -736,16 +735,16 @@ void ChessGameWindow::onPremoveMade(SimpleMove move)
 }
 
 // Slot for when a move is selected
-void ChessGameWindow::onMoveSelected(QSharedPointer<NotationMove>& move)
+void ChessGameWindow::onMoveSelected(NotationMovePtr& move)
 {
-    if (!move.isNull() && move->m_position) {
+    if (!move.isNull()) {
         m_notationViewer->m_selectedMove = move;
         m_notationViewer->refresh();
-        m_positionViewer->copyFrom(*move->m_position);
+        m_positionViewer->setPosition(move->m_position);
         m_positionViewer->setIsPreview(false);
         emit m_positionViewer->boardDataChanged();
         emit m_positionViewer->lastMoveChanged();
-        if (m_isGameplay && m_gameplayViewer->m_premoves.size() && move->m_nextMoves.size()) {
+        if (m_isGameplay && m_gameplayViewer->m_premoves.size() && move->nextMoves().size()) {
             m_gameplayViewer->m_premoves.clear();
             m_positionViewer->updatePremoves(m_gameplayViewer->m_premoves);
         }
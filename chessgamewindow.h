@@ -8,7 +8,7 @@ March 18, 2025: File Creation
 
 #include "notationviewer.h"
 #include "engineviewer.h"
-#include "chessposition.h"
+#include "positionviewer.h"
 #include "pgngame.h"
 #include "openingviewer.h"
 #include "gamereviewviewer.h"
@@ -61,7 +61,7 @@ public slots:
     void openingTeardown();
     void gameReviewSetup();
 
-    void onMoveHovered(QSharedPointer<NotationMove>& move);
+    void onMoveHovered(NotationMovePtr& move);
     void onNoHover();
 
 private slots:
@@ -70,9 +70,9 @@ private slots:
     void onSelectLastMove();
     void onRequestTakeback(QChar side);
 
-    void onMoveMade(QSharedPointer<NotationMove>& move);
+    void onMoveMade(NotationMovePtr& move);
     void onPremoveMade(SimpleMove move);
-    void onMoveSelected(QSharedPointer<NotationMove>& move);
+    void onMoveSelected(NotationMovePtr& move);
     void onEvalScoreChanged(double evalScore);
 
     void onPrevMoveShortcut();
@@ -98,7 +98,7 @@ private:
     NotationViewer* m_notationViewer;
     OpeningViewer* m_openingViewer;
     EngineWidget* m_engineViewer;
-    ChessPosition* m_positionViewer;
+    PositionViewer* m_positionViewer;
     GameReviewViewer *m_gameReviewViewer;
     GameplayViewer *m_gameplayViewer;
     QToolBar* m_Toolbar;
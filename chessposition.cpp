@@ -3,51 +3,67 @@ March 20, 2025: File Creation
 */
 
 #include "chessposition.h"
-#include "openingviewer.h"
+#include "notation.h"
 
 #include <QDebug>
 
-quint64 ZOBRIST_PIECE[12][64];
-quint64 ZOBRIST_CASTLING[16];
-quint64 ZOBRIST_EN_PASSANT_FILE[8];
-quint64 ZOBRIST_SIDE_TO_MOVE = 0;
+// Piece codes used by QML, indexed by bitboard piece
+static const QString PIECE_CODES[NO_PIECE + 1] = {
+    "wP", "wN", "wB", "wR", "wQ", "wK",
+    "bP", "bN", "bB", "bR", "bQ", "bK",
+    ""
+};
 
-ChessPosition::ChessPosition(QObject *parent)
-    : QObject(parent)
+static int pieceFromCode(const QString &code)
 {
-    m_boardData = convertFenToBoardData("");
-    m_plyCount = 0;
-    m_sideToMove = 'w';
+    if (code.size() < 2) return NO_PIECE;
+    int color = (code[0] == 'w' ? WHITE : BLACK);
+    switch (code[1].toLatin1()) {
+    case 'P': return makePiece(color, PAWN);
+    case 'N': return makePiece(color, KNIGHT);
+    case 'B': return makePiece(color, BISHOP);
+    case 'R': return makePiece(color, ROOK);
+    case 'Q': return makePiece(color, QUEEN);
+    case 'K': return makePiece(color, KING);
+    default: return NO_PIECE;
+    }
+}
+
+// PAWN when promo is not a promotion piece, as encodeMove expects for a plain move
+static int promoTypeFromChar(QChar promo)
+{
+    switch (promo.toUpper().toLatin1()) {
+    case 'N': return KNIGHT;
+    case 'B': return BISHOP;
+    case 'R': return ROOK;
+    case 'Q': return QUEEN;
+    default: return PAWN;
+    }
+}
 
-    m_castling.whiteKing = true;
-    m_castling.whiteQueen = true;
-    m_castling.blackKing = true;
-    m_castling.blackQueen = true;
+static int sideFromChar(QChar side)
+{
+    return side == 'w' ? WHITE : BLACK;
+}
 
-    m_enPassantTarget = '-';
-    m_halfmoveClock = 0;
-    m_fullmoveNumber = 1;
+ChessPosition::ChessPosition()
+{
+    m_board.setStartPosition();
 }
 
+// Builds the QML board representation from the bitboards on request
 QVector<QVector<QString>> ChessPosition::boardData() const
 {
-    return m_boardData;
+    QVector<QVector<QString>> data(8, QVector<QString>(8));
+    for (int sq = 0; sq < 64; sq++) {
+        data[rowOf(sq)][colOf(sq)] = PIECE_CODES[m_board.board[sq]];
+    }
+    return data;
 }
 
-void ChessPosition::copyFrom(const ChessPosition &other)
+void ChessPosition::setBoard(const BitboardPosition &board)
 {
-    m_boardData = other.m_boardData;
-    m_sideToMove = other.m_sideToMove;
-    m_castling.whiteKing = other.m_castling.whiteKing;
-    m_castling.blackKing = other.m_castling.blackKing;
-    m_castling.whiteQueen = other.m_castling.whiteQueen;
-    m_castling.blackQueen = other.m_castling.blackQueen;
-    m_enPassantTarget = other.m_enPassantTarget;
-    m_halfmoveClock = other.m_halfmoveClock;
-    m_fullmoveNumber = other.m_fullmoveNumber;
-    m_plyCount = other.m_plyCount;
-    m_lastMove = other.m_lastMove;
-    m_evalScore = other.m_evalScore;
+    m_board = board;
 }
 
 bool ChessPosition::validateMove(int oldRow, int oldCol, int newRow, int newCol, bool openingSpeedup) const
@@ -56,39 +72,41 @@ bool ChessPosition::validateMove(int oldRow, int oldCol, int newRow, int newCol,
         return false;
     }
 
-    QString fromSq = m_boardData[oldRow][oldCol];
-    if (fromSq.isEmpty())
+    int from = squareOf(oldRow, oldCol), to = squareOf(newRow, newCol);
+    int fromPiece = m_board.pieceAt(from);
+    if (fromPiece == NO_PIECE)
         return false;
 
-    QChar color = fromSq[0];
-    QChar piece = fromSq[1];
+    int color = pieceColor(fromPiece);
+    int piece = pieceType(fromPiece);
 
     // Ensure moving the right color
-    if (color.toLatin1() != m_sideToMove)
+    if (color != m_board.sideToMove)
         return false;
 
-    QString dstSq = m_boardData[newRow][newCol];
-    bool capture = !dstSq.isEmpty();
-    if (capture && dstSq[0] == color)
+    int dstPiece = m_board.pieceAt(to);
+    bool capture = dstPiece != NO_PIECE;
+    if (capture && pieceColor(dstPiece) == color)
         return false;
 
     int dr = newRow - oldRow;
     int dc = newCol - oldCol;
-    int adr = qAbs(dr), adc = qAbs(dc);
+    int adc = qAbs(dc);
 
-    if (piece == 'K' && oldRow == (color=='w'?7:0) && dr == 0 && adc == 2) {
+    if (piece == KING && oldRow == (color == WHITE ? 7 : 0) && dr == 0 && adc == 2) {
         bool kingSide = (dc == 2);
-        if (!(kingSide ? canCastleKingside(color) : canCastleQueenside(color))) return false;
+        QChar side = (color == WHITE ? 'w' : 'b');
+        if (!(kingSide ? canCastleKingside(side) : canCastleQueenside(side))) return false;
         // Path clear
         int step = kingSide ? 1 : -1;
         int rookCol = kingSide ? 7 : 0;
         for (int c = oldCol + step; c != rookCol; c += step) {
-            if (m_boardData[oldRow][c] != "") {
+            if (m_board.pieceAt(squareOf(oldRow, c)) != NO_PIECE) {
                 return false;
             }
         }
         for (int i = 0; i <= 2; i++){
-            if (squareAttacked(oldRow, oldCol + step*i, (color=='w'?'b':'w'))) {
+            if (m_board.squareAttacked(squareOf(oldRow, oldCol + step*i), color ^ 1)) {
                 return false;
             }
         }
@@ -96,75 +114,35 @@ bool ChessPosition::validateMove(int oldRow, int oldCol, int newRow, int newCol,
         return true;
     }
 
-    if (!openingSpeedup){
-        ChessPosition temp;
-        temp.copyFrom(*this);
-        temp.applyMove(oldRow, oldCol, newRow, newCol, '\0');
-        if (temp.inCheck(color))
-            return false;
+    if (!openingSpeedup && m_board.leavesKingInCheck(from, to)){
+        return false;
     }
 
-    switch (piece.toLatin1()) {
-    case 'P': {
-        int dir = (color == 'w' ? -1 : 1);
+    switch (piece) {
+    case PAWN: {
+        int dir = (color == WHITE ? -1 : 1);
         // single
-        if (dc == 0 && dr == dir && dstSq.isEmpty())
+        if (dc == 0 && dr == dir && !capture)
             return true;
         // double from start
-        if (dc == 0 && dr == 2*dir && oldRow == (color=='w'?6:1) && dstSq.isEmpty() && m_boardData[oldRow+dir][oldCol].isEmpty())
+        if (dc == 0 && dr == 2*dir && oldRow == (color == WHITE ? 6 : 1) && !capture && m_board.pieceAt(squareOf(oldRow+dir, oldCol)) == NO_PIECE)
             return true;
         // capture
-        if (adc == 1 && adr == 1 && dr == dir && (capture || m_enPassantTarget == QString(QChar('a'+newCol))+QString::number(8-newRow)))
+        if ((PAWN_ATTACKS[color][from] & squareBit(to)) && (capture || m_board.epSquare == to))
             return true;
         return false;
     }
-    case 'R': {
-        if ((dr == 0 && adc > 0) || (dc == 0 && adr > 0)) {
-            int stepR = (dr == 0 ? 0 : dr/adr);
-            int stepC = (dc == 0 ? 0 : dc/adc);
-            int r = oldRow + stepR, c = oldCol + stepC;
-            while (r != newRow || c != newCol) {
-                if (!m_boardData[r][c].isEmpty()) return false;
-                r += stepR; c += stepC;
-            }
-            return true;
-        }
-        return false;
-    }
-    case 'N': {
-        return ( (adr==2 && adc==1) || (adr==1 && adc==2) );
-    }
-    case 'B': {
-        if (adr == adc && adr > 0) {
-            int stepR = dr/adr, stepC = dc/adc;
-            int r = oldRow + stepR, c = oldCol + stepC;
-            while (r != newRow) {
-                if (!m_boardData[r][c].isEmpty()) return false;
-                r += stepR; c += stepC;
-            }
-            return true;
-        }
-        return false;
-    }
-    case 'Q': {
-        if ((adr == adc && adr > 0) || (dr == 0 && adc > 0) || (dc == 0 && adr > 0)) {
-            int stepR = (dr==0?0:dr/adr);
-            int stepC = (dc==0?0:dc/adc);
-            int r = oldRow + stepR, c = oldCol + stepC;
-            while (r != newRow || c != newCol) {
-                if (!m_boardData[r][c].isEmpty()) return false;
-                r += stepR; c += stepC;
-            }
-            return true;
-        }
-        return false;
-    }
-    case 'K': {
+    case KNIGHT:
+        return (KNIGHT_ATTACKS[from] & squareBit(to)) != 0;
+    case BISHOP:
+        return (bishopAttacks(from, m_board.occupied) & squareBit(to)) != 0;
+    case ROOK:
+        return (rookAttacks(from, m_board.occupied) & squareBit(to)) != 0;
+    case QUEEN:
+        return (queenAttacks(from, m_board.occupied) & squareBit(to)) != 0;
+    case KING:
         // Normal king move: one square any direction
-        if (adr <= 1 && adc <= 1)
-            return true;
-        return false;
-    }
+        return (KING_ATTACKS[from] & squareBit(to)) != 0;
     default:
         return false;
     }
@@ -172,44 +150,7 @@ bool ChessPosition::validateMove(int oldRow, int oldCol, int newRow, int newCol,
 
 bool ChessPosition::squareAttacked(int row, int col, QChar attacker) const
 {
-    // Pawn attacks
-    int dir = (attacker == 'w' ? 1 : -1);
-    for (int dc : {-1, 1}) {
-        int r = row + dir;
-        int c = col + dc;
-        if (r>=0 && r<8 && c>=0 && c<8 && m_boardData[r][c] == QString(attacker) + 'P')
-            return true;
-    }
-    // Knight attacks
-    static const QVector<QPair<int,int>> knightMoves = {{2,1},{2,-1},{-2,1},{-2,-1},{1,2},{1,-2},{-1,2},{-1,-2}};
-    for (auto &m : knightMoves) {
-        int r = row + m.first, c = col + m.second;
-        if (r>=0 && r<8 && c>=0 && c<8 && m_boardData[r][c] == QString(attacker) + 'N')
-            return true;
-    }
-    // Sliding pieces & king
-    static const QVector<QPair<int,int>> dirs = {{1,0},{-1,0},{0,1},{0,-1},{1,1},{1,-1},{-1,1},{-1,-1}};
-    for (auto &d : dirs) {
-        int r = row + d.first, c = col + d.second;
-        int dist = 1;
-        while (r>=0 && r<8 && c>=0 && c<8) {
-            QString sq = m_boardData[r][c];
-            if (!sq.isEmpty()) {
-                if (sq[0] == attacker) {
-                    char p = sq[1].toLatin1();
-                    // adjacent king
-                    if (dist==1 && p=='K') return true;
-                    // rook/queen
-                    if ((d.first==0||d.second==0) && (p=='R'||p=='Q')) return true;
-                    // bishop/queen
-                    if ((d.first!=0&&d.second!=0) && (p=='B'||p=='Q')) return true;
-                }
-                break;
-            }
-            r += d.first; c += d.second; dist++;
-        }
-    }
-    return false;
+    return m_board.squareAttacked(squareOf(row, col), sideFromChar(attacker));
 }
 
 bool ChessPosition::validatePremove(int sr, int sc, int dr, int dc) const
@@ -217,110 +158,30 @@ bool ChessPosition::validatePremove(int sr, int sc, int dr, int dc) const
     if (sr < 0 || sr >= 8 || sc < 0 || sc >= 8 || dr < 0 || dr >= 8 || dc < 0 || dc >= 8 || (sr == dr && sc == dc)){
         return false;
     }
-    if (!m_boardData[sr][sc].size() || m_boardData[sr][sc][0] == m_sideToMove){
+    int piece = m_board.pieceAt(squareOf(sr, sc));
+    if (piece == NO_PIECE || pieceColor(piece) == m_board.sideToMove){
         return false;
     }
     return true;
 }
 
-void ChessPosition::buildUserMove(int sr, int sc, int dr, int dc, QChar promo)
+bool ChessPosition::setBoardData(const QVector<QVector<QString>> &data)
 {
-    ChessPosition newPos;
-    newPos.copyFrom(*this);
-    newPos.applyMove(sr, sc, dr, dc, promo);
-
-    QString moveText = lanToSan(sr, sc, dr, dc, promo);
-    QSharedPointer<NotationMove> newMove(new NotationMove(moveText, newPos));
-    newMove->lanText = QString("%1%2%3%4").arg(QChar('a' + sc)).arg(8 - sr).arg(QChar('a' + dc)).arg(8 - dr);
-    newMove->m_zobristHash = newPos.computeZobrist();
+    if (boardData() == data) return false;
 
-    m_premoveEnabled = false;
-    emit moveMade(newMove);
-    emit boardDataChanged();
-}
-
-void ChessPosition::buildPremove(int sr, int sc, int dr, int dc, QChar promo)
-{
-    emit premoveMade({sr, sc, dr, dc, promo.toLatin1()});
-}
-
-void ChessPosition::release(int oldRow, int oldCol, int newRow, int newCol)
-{
-    if (m_premoveEnabled){
-        if (!validatePremove(oldRow, oldCol, newRow, newCol)){
-            return;
-        }
-        if (m_boardData[oldRow][oldCol][1] == 'P' && (newRow == 0 || newRow == 7)){
-            emit requestPromotion(oldRow, oldCol, newRow, newCol);
-        } else {
-            buildPremove(oldRow, oldCol, newRow, newCol, '\0');
-        }
-        return;
-    }
-    if (!validateMove(oldRow, oldCol, newRow, newCol)){
-        return;
-    }
-    if (m_boardData[oldRow][oldCol][1] == 'P' && (newRow == 0 || newRow == 7)){
-        emit requestPromotion(oldRow, oldCol, newRow, newCol);
-    } else {
-        buildUserMove(oldRow, oldCol, newRow, newCol, '\0');
-    }
-}
-
-void ChessPosition::promote(int sr, int sc, int dr, int dc, QChar promo)
-{
-    if (m_premoveEnabled){
-        buildPremove(sr, sc, dr, dc, promo);
-    } else {
-        buildUserMove(sr, sc, dr, dc, promo);
-    }
-}
-
-void ChessPosition::updatePremoves(QList<SimpleMove>& premoves)
-{
-    quint64 premoveSquare = 0;
-    for (int i = 0; i < premoves.size(); i++){
-        auto& [sr, sc, dr, dc, promo] = premoves[i];
-        if (!m_boardData[sr][sc].size()){
-            premoves.resize(i); // remaining premoves invalid
-            break;
-        } else {
-            premoveSquare |= ((1ULL<<static_cast<quint64>(sr*8+sc)) | (1ULL<<static_cast<quint64>(dr*8+dc))); // a8 = 0, h1 = 63
-            m_boardData[dr][dc] = m_boardData[sr][sc];
-            m_boardData[sr][sc] = "";
-        }
-    }
-    emit boardDataChanged();
-    setPremoveSq(premoveSquare);
-}
-
-void ChessPosition::insertPremove(SimpleMove premove)
-{
-    quint64 premoveSquare = m_premoveSq;
-    auto& [sr, sc, dr, dc, promo] = premove;
-    if (m_boardData[sr][sc].size() && m_boardData[sr][sc][0] != m_sideToMove){
-        premoveSquare |= ((1ULL<<static_cast<quint64>(sr*8+sc)) | (1ULL<<static_cast<quint64>(dr*8+dc))); // a8 = 0, h1 = 63
-        m_boardData[dr][dc] = m_boardData[sr][sc];
-        m_boardData[sr][sc] = "";
-        emit boardDataChanged();
-        setPremoveSq(premoveSquare);
+    // only piece placement is replaced, game state is kept
+    for (int piece = 0; piece < 12; piece++) m_board.pieces[piece] = 0;
+    m_board.occupancy[WHITE] = m_board.occupancy[BLACK] = m_board.occupied = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        m_board.board[sq] = NO_PIECE;
+        int piece = (rowOf(sq) < data.size() && colOf(sq) < data[rowOf(sq)].size()) ? pieceFromCode(data[rowOf(sq)][colOf(sq)]) : NO_PIECE;
+        if (piece != NO_PIECE) m_board.putPiece(sq, piece);
     }
+    m_board.key = m_board.computeHash();
+    return true;
 }
 
-void ChessPosition::setBoardData(const QVector<QVector<QString>> &data)
-{
-    if (m_boardData != data) {
-        m_boardData = data;
-        emit boardDataChanged();
-    }
-}
-
-QVector<QVector<QString>> ChessPosition::convertFenToBoardData(const QString &fen)
-{
-    return ::convertFenToBoardData(fen);  
-}
-
-bool ChessPosition::tryMakeMove(QString san, QSharedPointer<NotationMove> move, bool openingSpeedup) {
+bool ChessPosition::tryMakeMove(QString san, NotationMovePtr move, bool openingSpeedup) {
     san = san.trimmed();
     while (!san.isEmpty() && (san.endsWith('+') || san.endsWith('#'))){
         san.chop(1);
@@ -333,17 +194,15 @@ bool ChessPosition::tryMakeMove(QString san, QSharedPointer<NotationMove> move,
     // Handle castling
     if (san == "O-O" || san == "O-O-O") {
         bool kingSide = (san == "O-O");
-        QChar color = m_sideToMove;
+        QChar color = sideToMove();
         int row = (color=='w'?7:0);
         int oldKC = 4;
         int newKC = kingSide?6:2;
         int oldRC = kingSide?7:0;
         int newRC = kingSide?5:3;
         if (!validateMove(row, oldKC, row, newKC, openingSpeedup)) return false;
-        move->lanText = QString("%1%2%3%4").arg(QChar('a' + oldKC)).arg(8 - row).arg(QChar('a' + newKC)).arg(8 - row);
-        applyMove(row, oldKC, row, newKC, '\0');
-        if (color=='w') { m_castling.whiteKing=m_castling.whiteQueen=false; }
-        else { m_castling.blackKing=m_castling.blackQueen=false; }
+        move->m_move = encodeMove(squareOf(row, oldKC), squareOf(row, newKC));
+        applyMove(move->m_move);
         return true;
     }
 
@@ -411,8 +270,8 @@ bool ChessPosition::tryMakeMove(QString san, QSharedPointer<NotationMove> move,
     for (auto &o : candidates) {
         int sr = o.first, sc = o.second;
         if (validateMove(sr, sc, dr, dc, openingSpeedup)) {
-            move->lanText = QString("%1%2%3%4").arg(QChar('a' + sc)).arg(8 - sr).arg(QChar('a' + dc)).arg(8 - dr);
-            applyMove(sr, sc, dr, dc, promo);
+            move->m_move = encodeMove(squareOf(sr, sc), squareOf(dr, dc), promoTypeFromChar(promo));
+            applyMove(move->m_move);
             // update halfmove/fullmove…
             return true;
         }
@@ -422,142 +281,89 @@ bool ChessPosition::tryMakeMove(QString san, QSharedPointer<NotationMove> move,
 }
 
 void ChessPosition::applyMove(int sr, int sc, int dr, int dc, QChar promotion) {
-    QString from = m_boardData[sr][sc];
-    if (from.size() < 2) {
-        qDebug() << "Invalid ‘from’ string, aborting move.";
-        return;
-    }
-
-    // Update castling rights if king or rook moves
-    if (from[1]=='K') {
-        if (from[0]=='w') { m_castling.whiteKing=m_castling.whiteQueen=false; }
-        else { m_castling.blackKing=m_castling.blackQueen=false; }
-        // Rook relocation during castling
-        if (sc-dc == 2){
-            m_boardData[sr][sc-1] = m_boardData[sr][0];
-            m_boardData[sr][0] = "";
-        }
-        if (sc-dc == -2){
-            m_boardData[sr][sc+1] = m_boardData[sr][7];
-            m_boardData[sr][7] = "";
-        }
-    } else if (from[1]=='R') {
-        if (sr==7 && sc==0) m_castling.whiteQueen=false;
-        if (sr==7 && sc==7) m_castling.whiteKing=false;
-        if (sr==0 && sc==0) m_castling.blackQueen=false;
-        if (sr==0 && sc==7) m_castling.blackKing=false;
-    }
-    // Capture affects opponent rook rights
-    QString target = m_boardData[dr][dc];
-    if (!target.isEmpty() && target[1]=='R') {
-        if (dr==7 && dc==0) m_castling.whiteQueen=false;
-        if (dr==7 && dc==7) m_castling.whiteKing=false;
-        if (dr==0 && dc==0) m_castling.blackQueen=false;
-        if (dr==0 && dc==7) m_castling.blackKing=false;
-    }
-
-    // En passant capture
-    if (from[1]=='P' && qAbs(sc-dc)==1 && m_boardData[dr][dc].isEmpty()) {
-        QString dest = QString(QChar('a'+dc)) + QString::number(8 - dr);
-        if (m_enPassantTarget == dest) {
-            m_boardData[sr][dc] = "";
-        }
-    }
-
-    // Perform move
-    m_boardData[dr][dc] = from;
-    m_boardData[sr][sc] = "";
+    applyMove(squaresToMove(sr, sc, dr, dc, promotion));
+}
 
-    // Pawn double move: set en passant target
-    if (from[1]=='P' && qAbs(dr-sr)==2) {
-        int epRow = (sr+dr)/2;
-        m_enPassantTarget = QString(QChar('a'+sc)) + QString::number(8-epRow);
-    } else {
-        m_enPassantTarget = '-';
-    }
-    // Promotion
-    if (promotion!=QChar('\0') && from[1]=='P' && (dr==0||dr==7)) {
-        m_boardData[dr][dc] = QString(from[0]) + promotion.toUpper();
+void ChessPosition::applyMove(Move move) {
+    if (m_board.pieceAt(moveFrom(move)) == NO_PIECE) {
+        qDebug() << "Invalid ‘from’ square, aborting move.";
+        return;
     }
 
-    if (from[1] == 'P' || target.size()) m_halfmoveClock = 0;
-    else m_halfmoveClock++;
-    m_fullmoveNumber += (m_sideToMove == 'b');
-    m_sideToMove = (m_sideToMove=='w'?'b':'w');
+    UndoInfo undo;
+    m_board.makeMove(move, undo);
     m_plyCount++;
-    m_lastMove = ((sr * 8 + sc) << 8) | (dr * 8 + dc);
+    m_lastMove = (moveFrom(move) << 8) | moveTo(move);
+}
+
+void ChessPosition::relocatePiece(int sr, int sc, int dr, int dc)
+{
+    m_board.relocatePiece(squareOf(sr, sc), squareOf(dr, dc));
 }
 
 bool ChessPosition::inCheck(QChar side) const
 {
-    // Find king
-    for (int r=0; r<8; r++) {
-        for (int c=0; c<8; c++) {
-            if (m_boardData[r][c] == QString(side) + 'K') {
-                return squareAttacked(r, c, (side=='w'?'b':'w'));
-            }
-        }
-    }
-    return false;
+    return m_board.inCheck(sideFromChar(side));
+}
+
+QString ChessPosition::checkSuffix() const
+{
+    if (!m_board.inCheck(m_board.sideToMove)) return QString();
+    MoveList moves;
+    m_board.generateLegalMoves(moves);
+    return moves.size() ? QStringLiteral("+") : QStringLiteral("#");
 }
 
 bool ChessPosition::canCastleKingside(QChar side) const
 {
-    return (side == 'w' ? m_castling.whiteKing : m_castling.blackKing);
+    return m_board.castling & (side == 'w' ? WHITE_KING_SIDE : BLACK_KING_SIDE);
 }
 bool ChessPosition::canCastleQueenside(QChar side) const
 {
-    return (side == 'w' ? m_castling.whiteQueen : m_castling.blackQueen);
+    return m_board.castling & (side == 'w' ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE);
 }
 
 QVector<QPair<int,int>> ChessPosition::findPieceOrigins(QChar piece, const QString &dest, const QString &disamb) const {
     QVector<QPair<int,int>> vec;
-    for (int r = 0; r < 8; r++) {
-        for (int c = 0; c < 8; c++) {
-            QString sq = m_boardData[r][c];
-            if (sq.isEmpty()) continue;
-            if (sq[1] == piece && sq[0] == m_sideToMove) {
-                // Check file/rank disambiguation
-                if (!disamb.isEmpty()) {
-                    if (disamb[0].isLetter() && c != disamb[0].unicode()-'a') continue;
-                    if (disamb[0].isDigit() && r != disamb[0].digitValue()) continue;
-                }
-                vec.append(qMakePair(r,c));
-            }
-        }
+    int type = pieceFromCode(QString("w") + piece);
+    if (type == NO_PIECE) return vec;
+    Bitboard origins = m_board.pieces[makePiece(m_board.sideToMove, type)];
+    while (origins) {
+        int sq = popLsb(origins);
+        int r = rowOf(sq), c = colOf(sq);
+        // Check file/rank disambiguation
+        if (!disamb.isEmpty()) {
+            if (disamb[0].isLetter() && c != disamb[0].unicode()-'a') continue;
+            if (disamb[0].isDigit() && r != disamb[0].digitValue()) continue;
+        }
+        vec.append(qMakePair(r,c));
     }
     return vec;
 }
 
 bool ChessPosition::isFiftyMove() const
 {
-    return m_halfmoveClock >= 100;
+    return m_board.halfmoveClock >= 100;
 }
 
-QVector<SimpleMove> ChessPosition::generateLegalMoves() const
+MoveList ChessPosition::generateLegalMoves() const
 {
-    QVector<SimpleMove> legalMoves;
-    legalMoves.reserve(128);
-    const char promo[4] = {'N', 'B', 'R', 'Q'};
-    for (int sr = 0; sr < 8; sr++){
-        for (int sc = 0; sc < 8; sc++){
-            if (m_boardData[sr][sc].size() < 2) continue;
-            for (int dr = 0; dr < 8; dr++){
-                for (int dc = 0; dc < 8; dc++){
-                    if (!validateMove(sr, sc, dr, dc)) continue;
-                    if (sr == (m_sideToMove == 'w' ? 1 : 6) && m_boardData[sr][sc][1] == 'P'){
-                        for (auto c: promo) legalMoves.push_back({sr, sc, dr, dc, c});
-                    } else {
-                        legalMoves.push_back({sr, sc, dr, dc, '\0'});
-                    }
-                }
-            }
-        }
+    MoveList moves;
+    m_board.generateLegalMoves(moves);
+    return moves;
+}
+
+bool ChessPosition::isLegalMove(Move move) const
+{
+    MoveList moves;
+    m_board.generateLegalMoves(moves);
+    for (Move legal : moves) {
+        if (legal == move) return true;
     }
-    return legalMoves;
+    return false;
 }
 
-QString buildMoveText(const QSharedPointer<NotationMove>& move)
+QString buildMoveText(const NotationMovePtr& move)
 {
     QString fullMoveText;
     if (!move->commentBefore.isEmpty()) {
@@ -574,9 +380,9 @@ QString buildMoveText(const QSharedPointer<NotationMove>& move)
     return fullMoveText;
 }
 
-void writeMoves(const QSharedPointer<NotationMove>& move, QTextStream& out, int plyCount)
+void writeMoves(const NotationMovePtr& move, QTextStream& out, int plyCount)
 {
-    auto children = move->m_nextMoves;
+    auto children = move->nextMoves();
     if (children.isEmpty()) return;
 
     auto principal = children.first();
@@ -593,257 +399,44 @@ void writeMoves(const QSharedPointer<NotationMove>& move, QTextStream& out, int
     writeMoves(principal, out, plyCount);
 }
 
-void parseBodyAndBuild(QString &bodyText, QSharedPointer<NotationMove> rootMove, bool openingCutoff)
-{
-    if (!rootMove) return;
-    int n = bodyText.size();
-    int pos = 0, totalDepth = 0;
-    QString token;
-
-    // current parent (position *before* the next move)
-    QSharedPointer<NotationMove> curParent = rootMove;
-
-    // stack storing parents to restore when a ')' is seen
-    QVector<QSharedPointer<NotationMove>> variationStack;
-
-    auto attachCommentTo = [&](const QSharedPointer<NotationMove>& target, const QString& c){
-        if (!target) return;
-        if (!target->commentAfter.isEmpty()) target->commentAfter += " ";
-        target->commentAfter += c.trimmed();
-    };
-
-    auto stripMoveNumberPrefix = [](QString &tkn){
-        int m = tkn.size();
-        int p = 0;
-        while (p < m && tkn.at(p).isDigit()) ++p;
-        if (p > 0) {
-            int dotsStart = p;
-            while (p < m && tkn.at(p) == QChar('.')) ++p;
-            if (p > dotsStart) tkn.remove(0, p);
-        }
-        if (!tkn.isEmpty() && tkn.front().isSpace()) tkn.remove(0, 1);
-    };
-
-    auto processToken = [&](QString tkn)->bool {
-        // returns true to signal we should stop parsing (result token seen)
-        tkn = tkn.trimmed();
-        if (tkn.isEmpty()) return false;
-
-        // strip move number prefix (fast)
-        stripMoveNumberPrefix(tkn);
-        if (tkn.isEmpty()) return false;
-
-        // result tokens -> stop parsing this game/variation
-        if (tkn == "1-0" || tkn == "0-1" || tkn == "1/2-1/2" || tkn == "*") {
-            return true;
-        }
-
-        // NAG ($...) handling
-        if (tkn.startsWith('$')) {
-            bool ok = false;
-            int code = tkn.mid(1).toInt(&ok);
-            if (ok && NUMERIC_ANNOTATION_MAP.contains(code)) {
-                if (curParent) curParent->annotation1 = NUMERIC_ANNOTATION_MAP.value(code);
-            } else {
-                attachCommentTo(curParent, tkn);
-            }
-            return false;
-        }
-
-        // comments embedded as tokens (shouldn't normally happen)
-        if (tkn.startsWith('{')) {
-            if (tkn.endsWith('}')) {
-                QString inner = tkn.mid(1, tkn.size()-2).trimmed();
-                attachCommentTo(curParent, inner);
-            } else {
-                attachCommentTo(curParent, tkn.mid(1).trimmed());
-            }
-            return false;
-        }
-
-        if (openingCutoff && totalDepth >= MAX_OPENING_DEPTH) {
-            return false;
-        }
-
-        // Create child move
-        if (!curParent) return false; // defensive
-        QSharedPointer<NotationMove> child = QSharedPointer<NotationMove>::create(tkn, *curParent->m_position);
-        if (!child->m_position->tryMakeMove(tkn, child, openingCutoff)) {
-            // illegal move -> append as comment
-            attachCommentTo(curParent, tkn);
-            return false;
-        }
-
-        // success - link and advance current parent
-        child->m_zobristHash = child->m_position->computeZobrist();
-        linkMoves(curParent, child);
-        totalDepth++;
-
-        // advance: subsequent tokens belong to this child (continuation)
-        curParent = child;
-        return false;
-    };
-
-    // main loop: collect tokens and handle delimiters explicitly
-    while (pos < n) {
-        QChar ch = bodyText.at(pos);
-
-        // comment start: flush token first, then read full comment and attach
-        if (ch == '{') {
-            if (!token.isEmpty()) {
-                if (processToken(token)) return; // result token seen
-                token.clear();
-            }
-            ++pos; // consume '{'
-            QString comment;
-            while (pos < n) {
-                QChar cc = bodyText.at(pos++);
-                if (cc == '}') break;
-                comment += cc;
-            }
-            attachCommentTo(curParent, comment);
-            continue;
-        }
-
-        // open paren: variation start. Flush token first.
-        if (ch == '(') {
-            if (!token.isEmpty()) {
-                if (processToken(token)) return;
-                token.clear();
-            }
-            ++pos; // consume '('
-
-            // push current parent so we can restore after variation ends
-            variationStack.append(curParent);
-
-            // anchor variation at previous move when available
-            QSharedPointer<NotationMove> anchor = curParent;
-            if (curParent && !curParent->m_previousMove.isNull()) {
-                if (auto locked = curParent->m_previousMove.lock()) anchor = locked;
-            }
-            // start parsing variation anchored at 'anchor'
-            curParent = anchor;
-            continue;
-        }
-
-        // close paren: variation end. Flush token first.
-        if (ch == ')') {
-            if (!token.isEmpty()) {
-                if (processToken(token)) return;
-                token.clear();
-            }
-            ++pos; // consume ')'
-            if (!variationStack.isEmpty()) {
-                // restore parent to what it was before the '('
-                curParent = variationStack.takeLast();
-            } else {
-                // unmatched ')', be defensive: keep curParent as-is
-            }
-            continue;
-        }
-
-        // whitespace -> token boundary
-        if (ch.isSpace()) {
-            if (!token.isEmpty()) {
-                if (processToken(token)) return;
-                token.clear();
-            }
-            ++pos;
-            continue;
-        }
-
-        // default: regular token character
-        token += ch;
-        ++pos;
-    }
-
-    // if leftover token at EOF, process it
-    if (!token.isEmpty()) {
-        processToken(token);
-        token.clear();
-    }
-}
-
 QVector<QVector<QString>> convertFenToBoardData(const QString &fen)
 {
-    QString effectiveFen = fen.trimmed().isEmpty()
-    ? "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"
-    : fen;
-
-    QVector<QVector<QString>> boardData;
-    QStringList parts = effectiveFen.split(" ");
-    if (parts.isEmpty())
-        return boardData;
-
-    QString position = parts[0];
-    QStringList rows = position.split("/");
-    if (rows.size() != 8)
-        return boardData;  // Ensure it's a valid board representation
-
-    for (const QString &row : rows) {
-        QVector<QString> rowData;
-        for (int i = 0; i < row.length(); ++i) {
-            QChar ch = row[i];
-            if (ch.isDigit()) {
-                int emptyCount = ch.digitValue();
-                for (int j = 0; j < emptyCount; ++j)
-                    rowData.append("");
-            } else {
-                QString piece;
-                if (ch.isUpper())
-                    piece = "w" + QString(ch);
-                else
-                    piece = "b" + QString(ch).toUpper();
-                rowData.append(piece);
-            }
-        }
-        // Ensure that every row has exactly 8 columns
-        while (rowData.size() < 8)
-            rowData.append("");
-        boardData.append(rowData);
+    BitboardPosition position;
+    QByteArray latin1 = fen.trimmed().toLatin1();
+    if (latin1.isEmpty()) {
+        position.setStartPosition();
+    } else if (!position.setFen(std::string_view(latin1.constData(), latin1.size()))) {
+        return {};  // Not a valid board representation
     }
 
+    QVector<QVector<QString>> boardData(8, QVector<QString>(8));
+    for (int sq = 0; sq < 64; sq++) {
+        boardData[rowOf(sq)][colOf(sq)] = PIECE_CODES[position.board[sq]];
+    }
     return boardData;
 }
 
 QString ChessPosition::positionToFEN(bool forHash) const {
-    QStringList rowStr;
-    for (auto &row : m_boardData) {
-        QString s;
-        int empties = 0;
-        for (QString sq : row) {
-            if (sq.isEmpty()) { empties++; }
-            else {
-                if (empties) { s += QString::number(empties); empties = 0; }
-                QChar p = sq[1];
-                s += (sq[0] == 'w' ? p : p.toLower());
-            }
-        }
-        if (empties) s += QString::number(empties);
-        rowStr.append(s);
-    }
-    QString boardPart = rowStr.join('/');
-    QString sidePart = (m_sideToMove == 'w' ? "w" : "b");
-    QString cr;
-    if (m_castling.whiteKing)  cr += 'K';
-    if (m_castling.whiteQueen) cr += 'Q';
-    if (m_castling.blackKing)  cr += 'k';
-    if (m_castling.blackQueen) cr += 'q';
-    if (cr.isEmpty()) cr = "-";
-    QString ep = m_enPassantTarget;
-    QString hm = QString::number(m_halfmoveClock);
-    QString fm = QString::number(m_fullmoveNumber);
-    return QString("%1 %2 %3 %4").arg(boardPart, sidePart, cr, ep) + (forHash ? "" : QString(" %1 %2").arg(hm, fm));
+    char fen[FEN_BUFFER_SIZE];
+    int length = m_board.writeFen(fen, !forHash);
+    return QString::fromLatin1(fen, length);
 }
 
 QString ChessPosition::lanToSan(int sr, int sc, int dr, int dc, QChar promo) const
 {
-    const QString fromSq = m_boardData[sr][sc];
-    if (fromSq.size() < 2) {
+    return lanToSan(squaresToMove(sr, sc, dr, dc, promo));
+}
+
+QString ChessPosition::lanToSan(Move move) const
+{
+    const int sr = rowOf(moveFrom(move)), sc = colOf(moveFrom(move));
+    const int dr = rowOf(moveTo(move)), dc = colOf(moveTo(move));
+    const int fromPiece = m_board.pieceAt(squareOf(sr, sc));
+    if (fromPiece == NO_PIECE) {
         qDebug() << "Invalid ‘from’ string, aborting move.";
         return "";
     }
-    QChar piece = fromSq[1];  // 'P','N','B','R','Q','K'
+    QChar piece = QChar("PNBRQK"[pieceType(fromPiece)]);  // 'P','N','B','R','Q','K'
     bool isPawn = (piece == 'P');
 
     // castling
@@ -851,16 +444,15 @@ QString ChessPosition::lanToSan(int sr, int sc, int dr, int dc, QChar promo) con
         return (dc > sc ? "O-O" : "O-O-O");
     }
 
-    bool isCapture = !m_boardData[dr][dc].isEmpty() || (isPawn && qAbs(dc - sc)==1 && m_enPassantTarget == QString(QChar('a'+dc)) + QString::number(8-dr));
+    bool isCapture = m_board.pieceAt(squareOf(dr, dc)) != NO_PIECE || (isPawn && qAbs(dc - sc)==1 && m_board.epSquare == squareOf(dr, dc));
     QVector<QPair<int,int>> candidates;
-    QChar mySide = m_sideToMove;
-    for (int r = 0; r < 8; ++r) {
-        for (int c = 0; c < 8; ++c) {
-            const QString &sq = m_boardData[r][c];
-            if (sq.size()==2 && sq[0]==mySide && sq[1]==piece) {
-                if (!(r==sr && c==sc) && validateMove(r,c,dr,dc)) {
-                    candidates.append({r,c});
-                }
+    if (!isPawn) {
+        MoveList legalMoves;
+        m_board.generateLegalMoves(legalMoves);
+        for (Move legal : legalMoves) {
+            int from = moveFrom(legal);
+            if (moveTo(legal) == squareOf(dr, dc) && from != squareOf(sr, sc) && m_board.pieceAt(from) == fromPiece) {
+                candidates.append({rowOf(from), colOf(from)});
             }
         }
     }
@@ -893,102 +485,64 @@ QString ChessPosition::lanToSan(int sr, int sc, int dr, int dc, QChar promo) con
     san += QChar('a' + dc);
     san += QString::number(8 - dr);
 
-    // [romotion
-    if (promo != QChar('\0')) {
+    // promotion
+    if (movePromotion(move) != PAWN) {
         san += '=';
-        san += promo.toUpper();
+        san += QChar("PNBRQK"[movePromotion(move)]);
     }
 
     return san;
 }
 
-
-QSharedPointer<NotationMove> parseEngineLine(const QString& line, QSharedPointer<NotationMove> startMove)
+Move squaresToMove(int sr, int sc, int dr, int dc, QChar promo)
 {
-    QSharedPointer<NotationMove> newMove, tempMove = startMove, rootMove;
-    QString token;
-    int root = 1;
-    for (int i = 0; i < line.length(); i++){
-        if (line[i] != ' '){
-            token += line[i];
-        }
-        if (line[i] == ' ' || i+1 == line.length()){
-            if (token.size() < 4 || token.size() > 5)
-                continue;
-            int sc = token.at(0).toLatin1() - 'a', sr = 8 - token.at(1).digitValue();
-            int dc = token.at(2).toLatin1() - 'a', dr = 8 - token.at(3).digitValue();
-            QChar promo = (token.length() == 5 ? token.at(4) : QChar('\0'));
-
-            QSharedPointer<NotationMove> newMove = QSharedPointer<NotationMove>::create(token, *tempMove->m_position);
-            if (!newMove->m_position->validateMove(sr, sc, dr, dc)) {
-                break;
-            }
-            newMove->m_position->applyMove(sr, sc, dr, dc, promo);
-            newMove->moveText = tempMove->m_position->lanToSan(sr, sc, dr, dc, promo);
-            newMove->lanText = QString("%1%2%3%4").arg(QChar('a' + sc)).arg(8 - sr).arg(QChar('a' + dc)).arg(8 - dr);
-
-            if (!root){
-                linkMoves(tempMove, newMove);
-            } else {
-                rootMove = newMove;
-            }
-            root = 0;
-            token = "";
-            tempMove = newMove;
-        }
-    }
-    return rootMove;
+    return encodeMove(squareOf(sr, sc), squareOf(dr, dc), promoTypeFromChar(promo));
 }
 
-// Determinisic pseduo-random number generator for consistent zobrist hashes
-static quint64 splitmix64_next(quint64 &state)
+Move uciToMove(QStringView uci)
 {
-    state += 0x9E3779B97F4A7C15ull;
-    quint64 z = state;
-    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
-    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
-    z ^= (z >> 31);
-    return z;
+    if (uci.size() < 4 || uci.size() > 5) return NULL_MOVE;
+    int sc = uci[0].unicode() - 'a', sr = '8' - uci[1].unicode();
+    int dc = uci[2].unicode() - 'a', dr = '8' - uci[3].unicode();
+    if (sc < 0 || sc > 7 || sr < 0 || sr > 7 || dc < 0 || dc > 7 || dr < 0 || dr > 7) return NULL_MOVE;
+    return encodeMove(squareOf(sr, sc), squareOf(dr, dc), uci.size() == 5 ? promoTypeFromChar(uci[4]) : PAWN);
 }
 
-void initZobristTables()
+NotationMovePtr parseEngineLine(const QString& line, NotationMovePtr startMove)
 {
-    quint64 seed = 0xC0FFEE5EED1234ABull;
-    for (int i = 0; i < 12; i++){
-        for (int j = 0; j < 64; j++) {
-            ZOBRIST_PIECE[i][j] = splitmix64_next(seed);
+    NotationMovePtr tempMove = startMove, rootMove;
+    const QStringView view(line);
+    int pos = 0;
+    while (pos < view.size()) {
+        while (pos < view.size() && view[pos] == ' ') pos++;
+        int start = pos;
+        while (pos < view.size() && view[pos] != ' ') pos++;
+        if (pos == start) break;
+
+        Move move = uciToMove(view.mid(start, pos - start));
+        if (move == NULL_MOVE) continue;
+        if (!tempMove->m_position.isLegalMove(move)) {
+            break;
+        }
+
+        // the line is a tree of its own, its moves share one arena
+        QString san = tempMove->m_position.lanToSan(move);
+        NotationMovePtr newMove = rootMove.isNull() ? NotationMove::create(san, tempMove->m_position)
+                                                    : NotationMovePtr(rootMove->arena()->createMove(san, tempMove->m_position));
+        newMove->m_position.applyMove(move);
+        newMove->m_move = move;
+
+        if (!rootMove.isNull()){
+            linkMoves(tempMove, newMove);
+        } else {
+            rootMove = newMove;
         }
+        tempMove = newMove;
     }
-    for (int i = 0; i < 16; i++) ZOBRIST_CASTLING[i] = splitmix64_next(seed);
-    for (int i = 0; i < 8; i++) ZOBRIST_EN_PASSANT_FILE[i] = splitmix64_next(seed);
-    ZOBRIST_SIDE_TO_MOVE = splitmix64_next(seed);
+    return rootMove;
 }
 
 quint64 ChessPosition::computeZobrist() const
 {
-    const QHash<char,int> PIECE_INDEX_LOOKUP = {{'P', 0}, {'N', 1}, {'B', 2}, {'R', 3}, {'Q', 4}, {'K', 5}};
-    quint64 hash = 0;
-    for (int r = 0; r < 8; r++) {
-        for (int c = 0; c < 8; c++) {
-            QString sq = m_boardData[r][c];
-            if (sq.isEmpty()) continue;
-            int ind = PIECE_INDEX_LOOKUP.value(sq[1].toLatin1(), -100) + (sq[0].toLatin1() == 'w' ? 0 : 6);
-            if (ind >= 0) {
-                hash ^= ZOBRIST_PIECE[ind][r*8+c];
-            }
-        }
-    }
-    int cmask = 0;
-    if (m_castling.blackKing) cmask |= 1;
-    if (m_castling.blackQueen) cmask |= 2;
-    if (m_castling.whiteKing) cmask |= 4;
-    if (m_castling.whiteQueen) cmask |= 8;
-    hash ^= ZOBRIST_CASTLING[cmask];
-    if (!m_enPassantTarget.isEmpty() && m_enPassantTarget != "-"){
-        int ep = m_enPassantTarget[0].toLatin1() - 'a';
-        if (ep >= 0 && ep < 8) hash ^= ZOBRIST_EN_PASSANT_FILE[ep];
-    }
-
-    if (m_sideToMove == 'b') hash ^= ZOBRIST_SIDE_TO_MOVE;
-    return hash;
+    return m_board.key;
 }
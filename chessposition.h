@@ -7,17 +7,13 @@ March 20, 2025: File Creation
 
 #include <QString>
 #include <QVector>
-#include <QObject>
+#include <QMetaType>
+#include <QTextStream>
 #include <QDebug>
 
-#include "notation.h"
+#include "bitboard.h"
 
-struct CastlingRights {
-    bool whiteKing  = false;
-    bool whiteQueen = false;
-    bool blackKing  = false;
-    bool blackQueen = false;
-};
+class NotationMovePtr;
 
 struct SimpleMove {
     int sr, sc, dr, dc;
@@ -25,109 +21,52 @@ struct SimpleMove {
 };
 Q_DECLARE_METATYPE(SimpleMove)
 
-// Represents a chess position
-class ChessPosition: public QObject
+// Represents a chess position. A plain value, every move of a game tree holds one; the board
+// shown in QML is a PositionViewer that is given the position of the selected move
+class ChessPosition
 {
-    Q_OBJECT
-    Q_PROPERTY(QVector<QVector<QString>> boardData READ boardData WRITE setBoardData NOTIFY boardDataChanged)
-    Q_PROPERTY(double evalScore READ evalScore WRITE setEvalScore NOTIFY evalScoreChanged)
-    Q_PROPERTY(bool isPreview READ isPreview WRITE setIsPreview NOTIFY isPreviewChanged)
-    Q_PROPERTY(bool isBoardFlipped READ isBoardFlipped NOTIFY isBoardFlippedChanged)
-    Q_PROPERTY(bool isEvalActive READ isEvalActive NOTIFY isEvalActiveChanged)
-    Q_PROPERTY(quint64 premoveSq READ getPremoveSq NOTIFY premoveSqChanged)
-    Q_PROPERTY(int lastMove READ lastMove NOTIFY lastMoveChanged)
-
 public:
-    explicit ChessPosition(QObject *parent = nullptr);
+    ChessPosition();
 
+    // Board representation used by QML
     QVector<QVector<QString>> boardData() const;
-    void setBoardData(const QVector<QVector<QString>> &data);
-
-    // Called from Qml when the user tries to make a new move
-    Q_INVOKABLE void release(int sr, int sc, int dr, int dc);
-    Q_INVOKABLE void promote(int sr, int sc, int dr, int dc, QChar promo);
-    
-    // Called from QML to convert FEN string to board data
-    Q_INVOKABLE QVector<QVector<QString>> convertFenToBoardData(const QString &fen);
-
-    bool isPreview() const { return m_isPreview; }
-    void setIsPreview(bool p) {
-        if (m_isPreview == p) return;
-        m_isPreview = p;
-        emit isPreviewChanged(p);
-    }
-    bool isBoardFlipped() const { return m_isBoardFlipped; }
-    void flipBoard() {
-        m_isBoardFlipped = !m_isBoardFlipped;
-        emit isBoardFlippedChanged(m_isBoardFlipped);
-    }
+    // Replaces the piece placement and keeps the game state, returns false when nothing changed
+    bool setBoardData(const QVector<QVector<QString>> &data);
 
     int lastMove() const { return m_lastMove; }
 
     double evalScore() const { return m_evalScore; }
-    void setEvalScore(double v) {
-        m_evalScore = v;
-        emit evalScoreChanged();
-    }
-
-    bool isEvalActive() const { return m_isEvalActive; }
-    void setIsEvalActive(bool p) {
-        if (m_isEvalActive == p) return;
-        m_isEvalActive = p;
-        emit isEvalActiveChanged(p);
-    }
-
-    quint64 getPremoveSq() const { return m_premoveSq; }
-    void setPremoveSq(quint64 v) {
-        if (m_premoveSq == v) return;
-        m_premoveSq = v;
-        emit premoveSqChanged();
-    }
-    Q_INVOKABLE bool isPremoveSquare(int row, int col) const {
-        if (row*8 + col < 0 || row*8 + col >= 64) return false;
-        return ((m_premoveSq >> static_cast<quint64>(row*8 + col)) & 1ULL) != 0ULL;
-    }
+    void setEvalScore(double v) { m_evalScore = v; }
 
     int getPlyCount() const {return m_plyCount;}
+    char sideToMove() const { return m_board.sideToMove == WHITE ? 'w' : 'b'; }
+    const BitboardPosition& board() const { return m_board; }
 
-    // Copies all internal state from another ChessPosition
-    void copyFrom(const ChessPosition &other);
+    // Replaces the game state with a core position, e.g. one loaded from FEN
+    void setBoard(const BitboardPosition &board);
     QString positionToFEN(bool forHash = false) const;
     quint64 computeZobrist() const;
 
-    // Tries to make a new move from the current position given a SAN string
-    bool tryMakeMove(QString san, QSharedPointer<NotationMove> move, bool openingSpeedup = false);
+    // Tries to make a new move from the current position given a SAN string. Games are read with
+    // FastChessPosition; this slower reader, with findPieceOrigins, stays as the independent SAN
+    // decoder the perft cross-check compares FastChessPosition::sanToMove against
+    bool tryMakeMove(QString san, NotationMovePtr move, bool openingSpeedup = false);
     void applyMove(int sr, int sc, int dr, int dc, QChar promotion);
+    void applyMove(Move move);
+    // Moves a piece without any game state, used to show premoves
+    void relocatePiece(int sr, int sc, int dr, int dc);
     bool validateMove(int oldRow, int oldCol, int newRow, int newCol, bool openingSpeedup = false) const;
     bool validatePremove(int sr, int sc, int dr, int dc) const;
-    void buildUserMove(int sr, int sc, int dr, int dc, QChar promo);
-    void buildPremove(int sr, int sc, int dr, int dc, QChar promo);
-    void insertPremove(SimpleMove premove);
-    void updatePremoves(QList<SimpleMove> &premoves);
 
     QString lanToSan(int sr, int sc, int dr, int dc, QChar promo) const;
+    QString lanToSan(Move move) const;
 
     bool inCheck(QChar side) const;
+    // SAN suffix of the move that led here: "#" when the side to move is mated, "+" when in check
+    QString checkSuffix() const;
     bool isFiftyMove() const;
-    QVector<SimpleMove> generateLegalMoves() const;
-
-    char m_sideToMove;
-    bool m_premoveEnabled = false;
-
-signals:
-    // Signals QML to update board display
-    void boardDataChanged();
-    void requestPromotion(int sr, int sc, int dr, int dc);
-    // Signals ChessGameWindow to append new move to current selected move
-    void moveMade(QSharedPointer<NotationMove>& move);
-    void premoveMade(SimpleMove move);
-
-    void isPreviewChanged(bool);
-    void isBoardFlippedChanged(bool);
-    void isEvalActiveChanged(bool);
-    void premoveSqChanged();
-    void lastMoveChanged();
-    void evalScoreChanged();
+    MoveList generateLegalMoves() const;
+    bool isLegalMove(Move move) const;
 
 private:
     bool squareAttacked(int row, int col, QChar attacker) const;
@@ -137,28 +76,22 @@ private:
     // Finds possible origin squares for a given piece and destination`
     QVector<QPair<int,int>> findPieceOrigins(QChar piece, const QString &dest, const QString &sanDisamb) const;
 
-    QVector<QVector<QString>> m_boardData;
-    CastlingRights m_castling;
-    QString m_enPassantTarget;
-    int m_halfmoveClock;
-    int m_fullmoveNumber;
-    int m_plyCount;
+    BitboardPosition m_board;
+    int m_plyCount = 0;
 
     int m_lastMove = -1;
-    bool m_isPreview = false;
-    bool m_isBoardFlipped = false;
-    bool m_isEvalActive = false;
     double m_evalScore = 0;
-    quint64 m_premoveSq = 0;
 };
 
-void initZobristTables();
+QString buildMoveText(const NotationMovePtr& move);
+void writeMoves(const NotationMovePtr& move, QTextStream& out, int plyCount);
 
-QString buildMoveText(const QSharedPointer<NotationMove>& move);
-void writeMoves(const QSharedPointer<NotationMove>& move, QTextStream& out, int plyCount);
+// Board squares as given by QML, promo is a piece letter or '\\0'
+Move squaresToMove(int sr, int sc, int dr, int dc, QChar promo);
+// UCI text is only parsed at the engine boundary, see FastChessPosition::moveToUCI for output
+Move uciToMove(QStringView uci);
 
-QSharedPointer<NotationMove> parseEngineLine(const QString& line, QSharedPointer<NotationMove> startMove);
+NotationMovePtr parseEngineLine(const QString& line, NotationMovePtr startMove);
 QVector<QVector<QString>> convertFenToBoardData(const QString &fen);
-void parseBodyAndBuild(QString &bodyText, QSharedPointer<NotationMove> rootMove, bool openingCutoff);
 
 #endif // CHESSPOSITION_H
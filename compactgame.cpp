@@ -0,0 +1,151 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "compactgame.h"
+#include "fastchessposition.h"
+#include "notation.h"
+#include "openingviewer.h"
+#include "pgntokenizer.h"
+
+#include <vector>
+
+QSharedPointer<const CompactGame> CompactGame::parse(QStringView bodyText, const BitboardPosition &start, bool openingCutoff)
+{
+    QSharedPointer<CompactGame> game = QSharedPointer<CompactGame>::create();
+
+    // position and parent of every node while building, buffers reused across games
+    thread_local std::vector<FastChessPosition> positions;
+    thread_local std::vector<qint32> parents;
+    thread_local std::vector<PGNToken> tokens;
+    positions.resize(1);
+    positions[0].setBoard(start);
+    parents.assign(1, -1);
+    game->m_moves.append(NULL_MOVE);
+
+    // current parent (position *before* the next move)
+    qint32 curParent = 0;
+    int totalDepth = 0;
+
+    // stack storing parents to restore when a ')' is seen
+    QVector<qint32> variationStack;
+
+    auto attachCommentTo = [&](qint32 node, QStringView comment) {
+        QString &text = game->m_annotations[node].commentAfter;
+        if (!text.isEmpty()) text += QLatin1Char(' ');
+        text += comment.trimmed();
+    };
+
+    // returns true to signal we should stop parsing (result token seen)
+    auto processToken = [&](QStringView tkn) -> bool {
+        // strip move number prefix
+        qsizetype p = 0;
+        while (p < tkn.size() && tkn[p].isDigit()) ++p;
+        if (p > 0) {
+            qsizetype dotsStart = p;
+            while (p < tkn.size() && tkn[p] == QLatin1Char('.')) ++p;
+            if (p > dotsStart) tkn = tkn.mid(p);
+        }
+        if (tkn.isEmpty()) return false;
+
+        // result tokens -> stop parsing this game/variation
+        if (tkn == QLatin1String("1-0") || tkn == QLatin1String("0-1") || tkn == QLatin1String("1/2-1/2") || tkn == QLatin1String("*")) {
+            return true;
+        }
+
+        // NAG ($...) handling
+        if (tkn.startsWith(QLatin1Char('$'))) {
+            bool ok = false;
+            int code = tkn.mid(1).toInt(&ok);
+            if (ok && NUMERIC_ANNOTATION_MAP.contains(code)) {
+                game->m_annotations[curParent].annotation1 = NUMERIC_ANNOTATION_MAP.value(code);
+            } else {
+                attachCommentTo(curParent, tkn);
+            }
+            return false;
+        }
+
+        if (openingCutoff && totalDepth >= MAX_OPENING_DEPTH) {
+            return false;
+        }
+
+        Move move = positions[curParent].sanToMove(tkn);
+        if (move == NULL_MOVE) {
+            // illegal move -> append as comment
+            attachCommentTo(curParent, tkn);
+            return false;
+        }
+
+        // copied first, push_back may reallocate
+        FastChessPosition next = positions[curParent];
+        next.makeMove(move);
+        positions.push_back(next);
+        parents.push_back(curParent);
+        game->m_moves.append(move);
+        totalDepth++;
+
+        // advance: subsequent tokens belong to this child (continuation)
+        curParent = game->nodeCount() - 1;
+        return false;
+    };
+
+    tokenizeMovetext(bodyText, tokens);
+    for (const PGNToken &tkn : tokens) {
+        bool resultSeen = false;
+        switch (tkn.type) {
+        case PGN_COMMENT: {
+            // line breaks inside comments read as spaces
+            QString comment = bodyText.mid(tkn.offset, tkn.length).toString();
+            comment.replace(QLatin1Char('\n'), QLatin1Char(' '));
+            comment.remove(QLatin1Char('\r'));
+            attachCommentTo(curParent, comment);
+            break;
+        }
+        case PGN_VARIATION_START:
+            // push current parent so we can restore after variation ends,
+            // the variation itself is anchored at the previous move when available
+            variationStack.append(curParent);
+            if (parents[curParent] >= 0) curParent = parents[curParent];
+            break;
+        case PGN_VARIATION_END:
+            // unmatched ')' keeps the current parent
+            if (!variationStack.isEmpty()) curParent = variationStack.takeLast();
+            break;
+        case PGN_WORD:
+        case PGN_NAG:
+            resultSeen = processToken(bodyText.mid(tkn.offset, tkn.length));
+            break;
+        }
+        if (resultSeen) break;
+    }
+
+    // Nodes were numbered in creation order, so children come out in order here. Only nodes whose
+    // children are not exactly the next node get a branch entry
+    const qint32 count = game->nodeCount();
+    std::vector<qint32> childCount(count, 0);
+    for (qint32 node = 1; node < count; node++) childCount[parents[node]]++;
+    for (qint32 node = 1; node < count; node++) {
+        qint32 parent = parents[node];
+        if (childCount[parent] != 1 || node != parent + 1) game->m_branches[parent].append(node);
+    }
+    for (qint32 node = 0; node + 1 < count; node++) {
+        if (!childCount[node]) game->m_branches.insert(node, {});
+    }
+    game->m_moves.squeeze();
+
+    return game;
+}
+
+QVector<qint32> CompactGame::children(qint32 node) const
+{
+    auto branch = m_branches.constFind(node);
+    if (branch != m_branches.constEnd()) return branch.value();
+    if (node + 1 < nodeCount()) return {node + 1};
+    return {};
+}
+
+const CompactAnnotation *CompactGame::annotation(qint32 node) const
+{
+    auto it = m_annotations.constFind(node);
+    return it == m_annotations.constEnd() ? nullptr : &it.value();
+}
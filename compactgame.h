@@ -0,0 +1,45 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef COMPACTGAME_H
+#define COMPACTGAME_H
+
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+#include "bitboard.h"
+
+// Commentary of one node, only stored for the nodes that have any
+struct CompactAnnotation {
+    QString commentAfter;
+    QString annotation1;
+};
+
+// A parsed game tree without NotationMove nodes: one 16-bit move per node in movetext order plus
+// sparse side tables. Node 0 is the starting position. The only child of a node is the node after
+// it, unless the node has a branch entry, which lists its children instead (variations, line ends).
+// NotationMove creates nodes from this as they are visited, see NotationMove::nextMoves()
+class CompactGame
+{
+public:
+    // Parses movetext played from start. Tokens that are not legal moves are kept as comments,
+    // a result token ends the game
+    static QSharedPointer<const CompactGame> parse(QStringView bodyText, const BitboardPosition &start, bool openingCutoff = false);
+
+    qint32 nodeCount() const { return static_cast<qint32>(m_moves.size()); }
+    Move move(qint32 node) const { return m_moves[node]; }
+    QVector<qint32> children(qint32 node) const;
+    // Commentary of node, nullptr when it has none
+    const CompactAnnotation *annotation(qint32 node) const;
+
+private:
+    QVector<Move> m_moves;
+    QHash<qint32, QVector<qint32>> m_branches;
+    QHash<qint32, CompactAnnotation> m_annotations;
+};
+
+#endif // COMPACTGAME_H
@@ -3,6 +3,7 @@
 
 #include <QVBoxLayout>
 #include <QCheckBox>
+#include <QComboBox>
 #include <QLabel>
 #include <QQmlContext>
 
@@ -13,7 +14,7 @@ DatabaseFilter::DatabaseFilter(QWidget *parent)
     ui->setupUi(this);
     ui->WinsOnly->setEnabled(false);
 
-    mChessPosition = new ChessPosition(this);
+    mChessPosition = new PositionViewer(this);
     
     // starting pos
     QVector<QVector<QString>> startingBoard = {
@@ -29,10 +30,10 @@ DatabaseFilter::DatabaseFilter(QWidget *parent)
     mChessPosition->setBoardData(startingBoard);
     
     setupPositionTab();
+    _filter.zobrist = positionKey();
 
     // remove tabs for release since we have unfinished implementations
     delete ui->MaterialTab;
-    delete ui->PositionTab;
 }
 
 void DatabaseFilter::setupPositionTab()
@@ -51,14 +52,25 @@ void DatabaseFilter::setupPositionTab()
     
     layout->addWidget(mChessboardWidget);
 
+    // games are matched on the placement and side to move, castling rights and en passant are ignored
+    mSideToMove = new QComboBox(ui->PositionTab);
+    mSideToMove->addItem(tr("White to move"), int(WHITE));
+    mSideToMove->addItem(tr("Black to move"), int(BLACK));
+    layout->addWidget(mSideToMove);
+    mPositionCheck = new QCheckBox(tr("Find games reaching this position"), ui->PositionTab);
+    layout->addWidget(mPositionCheck);
+
     //connect qml
-    connect(mChessPosition, &ChessPosition::boardDataChanged, this, [this]() {
-        if (mChessPosition) {
-            const QString fen = mChessPosition->positionToFEN();
-            const quint64 zobrist = mChessPosition->computeZobrist();
-            onPositionChanged(fen, QVariant::fromValue(zobrist));
-        }
-    });
+    auto keyChanged = [this]() {
+        if (mChessPosition) onPositionChanged(mChessPosition->position().positionToFEN(), QVariant::fromValue(positionKey()));
+    };
+    connect(mChessPosition, &PositionViewer::boardDataChanged, this, keyChanged);
+    connect(mSideToMove, &QComboBox::currentIndexChanged, this, keyChanged);
+}
+
+quint64 DatabaseFilter::positionKey() const
+{
+    return mChessPosition->position().board().placementKey(mSideToMove->currentData().toInt());
 }
 
 DatabaseFilter::~DatabaseFilter()
@@ -87,6 +99,7 @@ DatabaseFilter::Filter DatabaseFilter::getNameFilters(){
     _filter.dateCheck = ui->DateCheck->isChecked();
     _filter.ecoCheck = ui->EcoCheck->isChecked();
     _filter.movesCheck = ui->MovesCheck->isChecked();
+    _filter.positionCheck = mPositionCheck->isChecked();
 
 
     
@@ -4,7 +4,9 @@
 #include <QDialog>
 #include <QDate>
 #include <QQuickWidget>
-#include "chessposition.h"
+#include <QCheckBox>
+#include <QComboBox>
+#include "positionviewer.h"
 
 
 namespace Ui {
@@ -19,11 +21,13 @@ class DatabaseFilter : public QDialog
 private:
     Ui::DatabaseFilter *ui;
     QQuickWidget *mChessboardWidget;
-    ChessPosition *mChessPosition;  
+    PositionViewer *mChessPosition;  
+    QComboBox *mSideToMove;
+    QCheckBox *mPositionCheck;
 
     struct Filter {
         QString whiteFirst, whiteLast, blackFirst, blackLast, tournament, annotator, ecoMin, ecoMax;
-        bool winsOnly, ignoreColours, dateCheck, ecoCheck, movesCheck;
+        bool winsOnly, ignoreColours, dateCheck, ecoCheck, movesCheck, positionCheck;
         int eloMin, eloMax, movesMin, movesMax;
         QDate dateMin, dateMax;
         quint64 zobrist;
@@ -40,6 +44,8 @@ private slots:
 
 private:
     void setupPositionTab();
+    // Placement key of the setup board with the chosen side to move
+    quint64 positionKey() const;
 };
 
 #endif // DATABASEFILTER_H
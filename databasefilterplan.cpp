@@ -0,0 +1,183 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "databasefilterplan.h"
+#include "databaseviewermodel.h"
+#include "parallel.h"
+
+static QDate parseDate(const QString &s){
+    QString t = s.trimmed();
+    if (t.isEmpty()) return QDate();
+    QDate d = QDate::fromString(t, Qt::ISODate);
+    if (d.isValid()) return d;
+
+    return QDate();
+}
+
+DatabaseFilterPlan::TextMatcher DatabaseFilterPlan::matcher(const QString &header, const QRegularExpression &regex)
+{
+    TextMatcher matcher;
+    matcher.header = header;
+    matcher.tag = DatabaseViewerModel::columnTag(header);
+    matcher.regex = regex;
+    matcher.regex.optimize();
+    matcher.matchesEmpty = matcher.regex.match(QString()).hasMatch();
+    matcher.perRow = header == "#" || header == "Moves";
+    return matcher;
+}
+
+bool DatabaseFilterPlan::isEmpty() const
+{
+    return m_text.empty() && m_ranges.empty() && m_players.empty() && !m_hasDateRange && !m_rejectAll;
+}
+
+void DatabaseFilterPlan::addText(const QString &header, const QRegularExpression &regex)
+{
+    m_text.push_back(matcher(header, regex));
+}
+
+void DatabaseFilterPlan::addRange(const QString &header, int lower, int higher)
+{
+    RangeCheck check{RangeCheck::Cell, header, lower, higher};
+    if (header == "#") check.source = RangeCheck::RowNumber;
+    else if (header == "Moves") check.source = RangeCheck::Moves;
+    else if (header == "wElo") check.source = RangeCheck::WhiteElo;
+    else if (header == "bElo") check.source = RangeCheck::BlackElo;
+    m_ranges.push_back(check);
+}
+
+void DatabaseFilterPlan::addPlayer(const QRegularExpression &regex)
+{
+    m_players.push_back(matcher("White", regex));
+    m_players.push_back(matcher("Black", regex));
+}
+
+void DatabaseFilterPlan::setDateRange(const QDate &min, const QDate &max)
+{
+    m_hasDateRange = true;
+    m_dateMin = min;
+    m_dateMax = max;
+    m_packedDateMin = HeaderStore::packDate(min.year(), min.month(), min.day());
+    m_packedDateMax = HeaderStore::packDate(max.year(), max.month(), max.day());
+}
+
+void DatabaseFilterPlan::TextMatcher::resolve(const HeaderStore &store) const
+{
+    if (perRow || column >= 0 || store.columnCount() == columnsSeen) return;
+    columnsSeen = store.columnCount();
+    column = store.column(tag);
+    if (column >= 0) perRow = !store.isTextOnly(column);
+}
+
+bool DatabaseFilterPlan::TextMatcher::matches(const HeaderStore &store, int game) const
+{
+    resolve(store);
+    if (perRow) return regex.match(DatabaseViewerModel::cellText(store, game, header)).hasMatch();
+    if (column < 0) return matchesEmpty;
+
+    quint32 id = store.valueId(game, column);
+    if (id >= matchOfId.size()) {
+        // values interned since the plan was prepared
+        const QStringList &dictionary = store.dictionary(column);
+        if (matchOfId.empty()) matchOfId.push_back(matchesEmpty);
+        for (qsizetype next = static_cast<qsizetype>(matchOfId.size()); next <= dictionary.size(); next++) {
+            matchOfId.push_back(regex.match(dictionary[next - 1]).hasMatch());
+        }
+    }
+    return matchOfId[id];
+}
+
+int DatabaseFilterPlan::RangeCheck::value(const HeaderStore &store, int game) const
+{
+    switch (source) {
+    case RowNumber: return game + 1;
+    case Moves: return qMax(0, (store.plyCount(game) + 1) / 2);
+    case WhiteElo: if (store.whiteElo(game)) return store.whiteElo(game); break;
+    case BlackElo: if (store.blackElo(game)) return store.blackElo(game); break;
+    case Cell: break;
+    }
+    return DatabaseViewerModel::cellNumber(store, game, header);
+}
+
+void DatabaseFilterPlan::prepare(const HeaderStore &store, const QThread *caller)
+{
+    for (std::vector<TextMatcher> *matchers : {&m_text, &m_players}) {
+        for (const TextMatcher &matcher : *matchers) {
+            matcher.resolve(store);
+            if (matcher.perRow || matcher.column < 0) continue;
+
+            // distinct values are matched on all cores, each into its own slot
+            const QStringList &dictionary = store.dictionary(matcher.column);
+            const qsizetype firstId = qMax<qsizetype>(1, static_cast<qsizetype>(matcher.matchOfId.size()));
+            matcher.matchOfId.resize(static_cast<size_t>(dictionary.size()) + 1);
+            matcher.matchOfId[0] = matcher.matchesEmpty;
+            parallelForChunks(dictionary.size() + 1 - firstId, [&](qsizetype begin, qsizetype end) {
+                if (caller->isInterruptionRequested()) return;
+                for (qsizetype id = firstId + begin; id < firstId + end; ++id) {
+                    matcher.matchOfId[id] = matcher.regex.match(dictionary[id - 1]).hasMatch();
+                }
+            });
+        }
+    }
+}
+
+bool DatabaseFilterPlan::accepts(const HeaderStore &store, int game) const
+{
+    if (m_rejectAll) return false;
+
+    //player filter, both players must be in the game when both are given
+    for (size_t i = 0; i + 1 < m_players.size(); i += 2) {
+        if (!m_players[i].matches(store, game) && !m_players[i + 1].matches(store, game)) return false;
+    }
+
+    //date filter
+    if (m_hasDateRange){
+        // PGN dates are compared packed, partly known ones sort before the first day of their month or year
+        quint32 date = store.date(game);
+        if (date) {
+            if (date < m_packedDateMin || date > m_packedDateMax) return false;
+        } else {
+            QDate isoDate = parseDate(store.value(game, QStringLiteral("Date")));
+            if (!isoDate.isValid()) {
+                return false;
+            }
+            if (isoDate < m_dateMin || isoDate > m_dateMax) return false;
+        }
+    }
+
+    for (const TextMatcher &matcher : m_text) {
+        if (!matcher.matches(store, game)) return false;
+    }
+
+    for (const RangeCheck &check : m_ranges) {
+        int data = check.value(store, game);
+        if(!(check.lower <= data && data <= check.higher)) return false;
+    }
+
+    return true;
+}
+
+std::vector<quint64> DatabaseFilterPlan::run(const HeaderStore &store)
+{
+    // chunks run on pool threads, so they check the thread that asked for the run
+    const QThread *caller = QThread::currentThread();
+    prepare(store, caller);
+
+    // each chunk writes whole words, so no two threads touch the same word
+    const qsizetype games = store.size();
+    std::vector<quint64> accepted(static_cast<size_t>((games + 63) / 64), 0);
+    parallelForChunks(static_cast<qsizetype>(accepted.size()), [&](qsizetype begin, qsizetype end) {
+        if (caller->isInterruptionRequested()) return;
+        for (qsizetype word = begin; word < end; ++word) {
+            quint64 bits = 0;
+            const qsizetype first = word * 64;
+            const int count = static_cast<int>(qMin<qsizetype>(64, games - first));
+            for (int bit = 0; bit < count; ++bit) {
+                if (accepts(store, static_cast<int>(first + bit))) bits |= 1ULL << bit;
+            }
+            accepted[word] = bits;
+        }
+    }, 16);
+    return accepted;
+}
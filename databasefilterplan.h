@@ -0,0 +1,81 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef DATABASEFILTERPLAN_H
+#define DATABASEFILTERPLAN_H
+
+#include <QDate>
+#include <QRegularExpression>
+#include <QString>
+
+#include <vector>
+
+#include "headerstore.h"
+
+class QThread;
+
+// The filters of a game list compiled against the columns of its header store. Text filters on
+// tags kept as text are matched once per distinct value, a game then looks its result up by
+// dictionary id; ratings, move counts and dates are compared as integers
+class DatabaseFilterPlan
+{
+public:
+    bool isEmpty() const;
+
+    // header is a column of the table, see DatabaseViewerModel::columnTag()
+    void addText(const QString &header, const QRegularExpression &regex);
+    void addRange(const QString &header, int lower, int higher);
+    // A player that must be in the game with either colour
+    void addPlayer(const QRegularExpression &regex);
+    void setDateRange(const QDate &min, const QDate &max);
+    void rejectAll() { m_rejectAll = true; }
+
+    // Checks one game, values not seen by the plan before are matched as they first appear
+    bool accepts(const HeaderStore &store, int game) const;
+    // Bit i % 64 of word i / 64 is set when game i of store is accepted, evaluated on all cores.
+    // Chunks left when the calling thread is asked to stop are skipped, the result is then partial
+    std::vector<quint64> run(const HeaderStore &store);
+
+private:
+    // Matches every value of the text columns of store on all cores, after which accepts() only
+    // reads the plan for the games of store and can be called from several threads at once
+    void prepare(const HeaderStore &store, const QThread *caller);
+
+    struct TextMatcher {
+        QString header;
+        QString tag;
+        QRegularExpression regex;
+        bool matchesEmpty = false;
+        // resolved on first use, the tag may only appear in games added later
+        mutable int column = -1;
+        mutable int columnsSeen = -1;
+        mutable bool perRow = false; // "#", "Moves" and integer tags are matched on their text
+        mutable std::vector<quint8> matchOfId;
+
+        void resolve(const HeaderStore &store) const;
+        bool matches(const HeaderStore &store, int game) const;
+    };
+
+    struct RangeCheck {
+        enum Source { RowNumber, Moves, WhiteElo, BlackElo, Cell };
+        Source source;
+        QString header;
+        int lower, higher;
+
+        int value(const HeaderStore &store, int game) const;
+    };
+
+    static TextMatcher matcher(const QString &header, const QRegularExpression &regex);
+
+    std::vector<TextMatcher> m_text;
+    std::vector<RangeCheck> m_ranges;
+    // a matcher on White then one on Black for each player
+    std::vector<TextMatcher> m_players;
+    bool m_hasDateRange = false;
+    QDate m_dateMin, m_dateMax;
+    quint32 m_packedDateMin = 0, m_packedDateMax = 0;
+    bool m_rejectAll = false;
+};
+
+#endif // DATABASEFILTERPLAN_H
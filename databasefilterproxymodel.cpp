@@ -1,16 +1,61 @@
 #include "databasefilterproxymodel.h"
 
-//static
-static QDate parseDate(const QString &s){
-    QString t = s.trimmed();
-    if (t.isEmpty()) return QDate();
-    QDate d = QDate::fromString(t, Qt::ISODate);
-    if (d.isValid()) return d;
+// Tables up to this many rows are filtered on the GUI thread, it takes less than starting a thread
+static const qsizetype BACKGROUND_FILTER_ROWS = 50000;
 
-    return QDate();
+DatabaseFilterProxyModel::DatabaseFilterProxyModel(QObject *parent) : QSortFilterProxyModel{parent}{}
+
+DatabaseFilterProxyModel::~DatabaseFilterProxyModel(){
+    // runs post their result to this model, none may outlive it
+    mStoppingThreads.append(mFilterThread);
+    for (const QPointer<QThread> &thread : mStoppingThreads) {
+        if (!thread) continue;
+        thread->requestInterruption();
+        thread->wait();
+    }
 }
 
-DatabaseFilterProxyModel::DatabaseFilterProxyModel(QObject *parent) : QSortFilterProxyModel{parent}{}
+void DatabaseFilterProxyModel::setSourceModel(QAbstractItemModel *sourceModel){
+    if (this->sourceModel()) disconnect(this->sourceModel(), nullptr, this, nullptr);
+
+    // connected before the proxy's own handlers, so rows are never checked against a stale bitmap
+    connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+        // ids of the emptied store will mean other values
+        mPlan = compile();
+        dropAccepted();
+        dropSortKeys();
+    });
+    connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &DatabaseFilterProxyModel::dropAccepted);
+    connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &DatabaseFilterProxyModel::dropSortKeys);
+    connect(sourceModel, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        mSortKeys.replace(games()->headerStore(), topLeft.row(), bottomRight.row());
+        if (mFilterThread) {
+            // the running filter saw the old values
+            refilter();
+            return;
+        }
+        for (int row = topLeft.row(); row <= bottomRight.row() && row < mAcceptedRows; row++) {
+            quint64 bit = 1ULL << (row % 64);
+            if (mPlan.accepts(games()->headerStore(), row)) mAccepted[row / 64] |= bit;
+            else mAccepted[row / 64] &= ~bit;
+        }
+        // the movetext of an edited game may have changed too
+        for (int row = topLeft.row(); row <= bottomRight.row() && row < mPositionRowCount; row++) {
+            quint64 bit = 1ULL << (row % 64);
+            if (games()->reachesPosition(row, mPosition)) mPositionRows[row / 64] |= bit;
+            else mPositionRows[row / 64] &= ~bit;
+        }
+    });
+    // filters only apply to columns of the table
+    connect(sourceModel, &QAbstractItemModel::columnsInserted, this, &DatabaseFilterProxyModel::refilter);
+    connect(sourceModel, &QAbstractItemModel::columnsRemoved, this, &DatabaseFilterProxyModel::refilter);
+    connect(sourceModel, &QAbstractItemModel::columnsInserted, this, &DatabaseFilterProxyModel::dropSortKeys);
+    connect(sourceModel, &QAbstractItemModel::columnsRemoved, this, &DatabaseFilterProxyModel::dropSortKeys);
+
+    dropSortKeys();
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+    refilter();
+}
 
 // Filter by text
 void DatabaseFilterProxyModel::setTextFilter(QString header, const QString &pattern){
@@ -21,7 +66,7 @@ void DatabaseFilterProxyModel::setTextFilter(QString header, const QString &patt
         textFilters[header] = QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption);
     }
 
-    invalidateFilter();
+    refilter();
 }
 
 // Filter by range
@@ -29,7 +74,7 @@ void DatabaseFilterProxyModel::setRangeFilter(QString header, int lower, int hig
 
     rangeFilters[header] = {lower, higher};
 
-    invalidateFilter();
+    refilter();
 
 }
 
@@ -52,7 +97,7 @@ void DatabaseFilterProxyModel::setPlayerFilter(const QString& whiteFirst, const
     }
     
     
-    invalidateFilter();
+    refilter();
 }
 
 void DatabaseFilterProxyModel::setDateFilter(const QDate &minDate, const QDate &maxDate){
@@ -61,7 +106,17 @@ void DatabaseFilterProxyModel::setDateFilter(const QDate &minDate, const QDate &
     
     mDateMin = minDate;
     mDateMax = maxDate;
-    invalidateFilter();
+    refilter();
+}
+
+void DatabaseFilterProxyModel::setPositionFilter(quint64 position){
+    mHasPositionFilter = true;
+    mPosition = position;
+    refilter();
+}
+
+void DatabaseFilterProxyModel::positionIndexChanged(){
+    if (mHasPositionFilter) refilter();
 }
 
 // reset/clear all filters
@@ -81,145 +136,146 @@ void DatabaseFilterProxyModel::resetFilters()
     mDateMax = QDate();
     mHasDateFilter = false;
 
-    invalidateFilter();
-}
-
-// Translate filters to display
-bool DatabaseFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const{
-
-    //player filter
-    if(mHasPlayerFilter){
-        //get indices
-        int whiteCol = -1, blackCol = -1;
-        for(int i = 0; i < sourceModel()->columnCount(); i++) {
-            QVariant headerData = sourceModel()->headerData(i, Qt::Horizontal);
-            QString headerName = headerData.toString();
-            if(headerName == "White") whiteCol = i;
-            else if(headerName == "Black") blackCol = i;
-        }
-
-        if (whiteCol >= 0 && blackCol >= 0) {
-            QModelIndex whiteIndex = sourceModel()->index(sourceRow, whiteCol, sourceParent);
-            QModelIndex blackIndex = sourceModel()->index(sourceRow, blackCol, sourceParent);
-            QString whitePlayer = sourceModel()->data(whiteIndex).toString();
-            QString blackPlayer = sourceModel()->data(blackIndex).toString();
-
-            if(mIgnoreColour){
-                QString player1Pattern, player2Pattern;
-                
-                if (!mWhiteFirst.isEmpty() || !mWhiteLast.isEmpty()) {
-                    QStringList parts;
-                    if (!mWhiteFirst.isEmpty()) parts << mWhiteFirst;
-                    if (!mWhiteLast.isEmpty()) parts << mWhiteLast;
-                    player1Pattern = QString("^(?=.*%1).*").arg(parts.join(")(?=.*"));
-                }
-                
-                if (!mBlackFirst.isEmpty() || !mBlackLast.isEmpty()) {
-                    QStringList parts;
-                    if (!mBlackFirst.isEmpty()) parts << mBlackFirst;
-                    if (!mBlackLast.isEmpty()) parts << mBlackLast;
-                    player2Pattern = QString("^(?=.*%1).*").arg(parts.join(")(?=.*"));
-                }
-
-                bool hasPlayer1 = false, hasPlayer2 = false;
-                
-                if (!player1Pattern.isEmpty()) {
-                    QRegularExpression regex1(player1Pattern, QRegularExpression::CaseInsensitiveOption);
-                    hasPlayer1 = regex1.match(whitePlayer).hasMatch() || regex1.match(blackPlayer).hasMatch();
-                }
-                
-                if (!player2Pattern.isEmpty()) {
-                    QRegularExpression regex2(player2Pattern, QRegularExpression::CaseInsensitiveOption);
-                    hasPlayer2 = regex2.match(whitePlayer).hasMatch() || regex2.match(blackPlayer).hasMatch();
-                }
-                
-                //if both check both else check each
-                if (!player1Pattern.isEmpty() && !player2Pattern.isEmpty()) {
-                    if (!hasPlayer1 || !hasPlayer2) return false;
-                } else {
-                    if (!player1Pattern.isEmpty() && !hasPlayer1) return false;
-                    if (!player2Pattern.isEmpty() && !hasPlayer2) return false;
-                }
+    mHasPositionFilter = false;
 
-            }
-            
-        }
+    refilter();
+}
 
+DatabaseFilterPlan DatabaseFilterProxyModel::compile() const{
+    DatabaseFilterPlan plan;
+    if (!sourceModel()) return plan;
+
+    //player filter, only when colours are ignored; otherwise it is a text filter on each colour
+    if(mHasPlayerFilter && mIgnoreColour && games()->headerIndex("White") >= 0 && games()->headerIndex("Black") >= 0){
+        auto addPlayer = [&plan](const QString &first, const QString &last) {
+            if (first.isEmpty() && last.isEmpty()) return;
+            QStringList parts;
+            if (!first.isEmpty()) parts << first;
+            if (!last.isEmpty()) parts << last;
+            plan.addPlayer(QRegularExpression(QString("^(?=.*%1).*").arg(parts.join(")(?=.*")), QRegularExpression::CaseInsensitiveOption));
+        };
+        addPlayer(mWhiteFirst, mWhiteLast);
+        addPlayer(mBlackFirst, mBlackLast);
     }
 
     //date filter
     if (mHasDateFilter){
-        int col = -1;
+        bool hasDateColumn = false;
         for (int i = 0; i < sourceModel()->columnCount(); ++i) {
-            QVariant headerData = sourceModel()->headerData(i, Qt::Horizontal);
-            if (headerData.toString().compare("Date", Qt::CaseInsensitive) == 0) {
-                col = i;
+            if (sourceModel()->headerData(i, Qt::Horizontal).toString().compare("Date", Qt::CaseInsensitive) == 0) {
+                hasDateColumn = true;
                 break;
             }
         }
-        if (col < 0) {
-            return false;
-        }
-        QModelIndex idx = sourceModel()->index(sourceRow, col, sourceParent);
-        QString dateStr = sourceModel()->data(idx).toString();
-        QDate rowDate = parseDate(dateStr);
-        if (!rowDate.isValid()) {
-            return false;
-        }
-        if (rowDate < mDateMin || rowDate > mDateMax) return false;
+        if (hasDateColumn) plan.setDateRange(mDateMin, mDateMax);
+        else plan.rejectAll();
     }
 
-
     for(auto [key, value]: textFilters.asKeyValueRange()){
-        // iterate through rows and apply text filter
-        int col = -1;
-        for(int i = 0; i < sourceModel()->columnCount(); i++){
-            QVariant headerData = sourceModel()->headerData(i, Qt::Horizontal);
-            if(headerData.toString() == key){
-                col = i; break;
-            }
-        }
-
-        if(col >= 0){
-            QModelIndex index = sourceModel()->index(sourceRow, col, sourceParent);
-            QString data = sourceModel()->data(index).toString();
-            if(!value.match(data).hasMatch()) return false;
-        }
+        if(games()->headerIndex(key) >= 0) plan.addText(key, value);
     }
 
     for(auto [key, value]: rangeFilters.asKeyValueRange()){
-        // iterate through rows and apply range filter
-        int col = -1;
-        for(int i = 0; i < sourceModel()->columnCount(); i++){
-            QVariant headerData = sourceModel()->headerData(i, Qt::Horizontal);
-            if(headerData.toString() == key){
-                col = i; break;
-            }
-        }
+        if(games()->headerIndex(key) >= 0) plan.addRange(key, value.first, value.second);
+    }
+    return plan;
+}
 
-        if(col >= 0){
-            QModelIndex index = sourceModel()->index(sourceRow, col, sourceParent);
-            int data = sourceModel()->data(index).toString().toInt();
-            if(!(value.first <= data && data <= value.second)) return false;
-        }
+void DatabaseFilterProxyModel::refilter(){
+    if (!sourceModel()) return;
+    const int generation = ++mGeneration;
+    // a run in progress stops at its next chunk, its result is dropped by the generation check
+    mStoppingThreads.removeAll(nullptr);
+    if (mFilterThread) {
+        mFilterThread->requestInterruption();
+        mStoppingThreads.append(mFilterThread);
+        mFilterThread.clear();
+    }
 
+    // a binary search and a scan of the position's posting list, shown with the plan's result
+    mPositionRows.clear();
+    mPositionRowCount = 0;
+    if (mHasPositionFilter) {
+        mPositionRows = games()->rowsReaching(mPosition);
+        mPositionRowCount = games()->rowCount();
+    }
 
+    DatabaseFilterPlan plan = compile();
+    const HeaderStore &store = games()->headerStore();
+    if (plan.isEmpty()) {
+        applyPlan(plan, {}, 0);
+        return;
+    }
+    if (store.size() < BACKGROUND_FILTER_ROWS) {
+        std::vector<quint64> accepted = plan.run(store);
+        applyPlan(plan, std::move(accepted), store.size());
+        return;
     }
 
-    return true;
+    // the worker shares the store, the model copies it only if games are added or edited while the
+    // run reads it; the rows shown keep the previous filters until it is done
+    mFilterThread = QThread::create([this, plan, shared = games()->sharedHeaderStore(), generation]() mutable {
+        std::vector<quint64> accepted = plan.run(*shared.constData());
+        const qsizetype rows = shared.constData()->size();
+        // let go of the store before the thread object is deleted, the model need not copy it any more
+        shared.reset();
+        if (QThread::currentThread()->isInterruptionRequested()) return;
+        QMetaObject::invokeMethod(this, [this, plan, accepted = std::move(accepted), rows, generation]() {
+            if (generation == mGeneration) applyPlan(plan, accepted, rows);
+        }, Qt::QueuedConnection);
+    });
+    connect(mFilterThread, &QThread::finished, mFilterThread, &QObject::deleteLater);
+    mFilterThread->start();
 }
 
-// Custom comparator for integer sorting
-bool DatabaseFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const{
-    QString headerName = sourceModel()->headerData(left.column(), Qt::Horizontal).toString();
-    QVector<QString> numericHeaders {"Number", "#", "Elo", "Move", "Moves"};
+void DatabaseFilterProxyModel::applyPlan(const DatabaseFilterPlan &plan, std::vector<quint64> accepted, qsizetype acceptedRows){
+    mPlan = plan;
+    mAccepted = std::move(accepted);
+    mAcceptedRows = acceptedRows;
+    invalidateFilter();
+}
 
-    if(std::find(numericHeaders.begin(), numericHeaders.end(), headerName) != numericHeaders.end()){
-        return sourceModel()->data(left).toString().toInt() < sourceModel()->data(right).toString().toInt();
-    }
+void DatabaseFilterProxyModel::dropAccepted(){
+    // rows are checked against the plan one by one from now on
+    ++mGeneration;
+    mAccepted.clear();
+    mAcceptedRows = 0;
+    mPositionRows.clear();
+    mPositionRowCount = 0;
+}
+
+bool DatabaseFilterProxyModel::reachesPosition(int sourceRow) const{
+    if (!mHasPositionFilter) return true;
+    if (sourceRow < mPositionRowCount) return (mPositionRows[sourceRow / 64] >> (sourceRow % 64)) & 1;
+    return games()->reachesPosition(sourceRow, mPosition);
+}
 
-    return QSortFilterProxyModel::lessThan(left, right);
+// Translate filters to display
+bool DatabaseFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const{
+    if (!reachesPosition(sourceRow)) return false;
+    if (sourceRow < mAcceptedRows) return (mAccepted[sourceRow / 64] >> (sourceRow % 64)) & 1;
+    // rows added since the last run
+    return mPlan.accepts(games()->headerStore(), sourceRow);
 }
 
+void DatabaseFilterProxyModel::dropSortKeys(){
+    mSortKeys.clear();
+    mSortKeysColumn = -1;
+}
 
+const DatabaseSortKeys &DatabaseFilterProxyModel::sortKeys(int column) const{
+    const HeaderStore &store = games()->headerStore();
+    if (column != mSortKeysColumn || sortCaseSensitivity() != mSortKeys.caseSensitivity()) {
+        mSortKeys.build(store, sourceModel()->headerData(column, Qt::Horizontal).toString(), sortCaseSensitivity());
+        mSortKeysColumn = column;
+    } else if (mSortKeys.size() < store.size()) {
+        mSortKeys.update(store);
+    }
+    return mSortKeys;
+}
 
+// Compares the precomputed sort keys of the sorted column
+bool DatabaseFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const{
+    const DatabaseSortKeys &keys = sortKeys(left.column());
+    return keys.key(left.row()) < keys.key(right.row());
+}
@@ -2,18 +2,38 @@
 #define DATABASEFILTERPROXYMODEL_H
 
 #include <QSortFilterProxyModel>
+#include <QRegularExpression>
 #include <QDate>
+#include <QPointer>
+#include <QList>
+#include <QThread>
 
-// Model for efficient search and sort of a table
+#include <vector>
+
+#include "databaseviewermodel.h"
+#include "databasefilterplan.h"
+#include "databasesortkeys.h"
+
+// Model for efficient search and sort of a table, cells are read from the source model's header store.
+// Filters are compiled into a plan when they are set and run over the whole table on all cores,
+// the proxy then only reads the resulting row bitmap
 class DatabaseFilterProxyModel : public QSortFilterProxyModel
 {
 public:
     explicit DatabaseFilterProxyModel(QObject *parent = nullptr);
+    ~DatabaseFilterProxyModel();
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
 
     void setTextFilter(QString header, const QString &pattern);
     void setRangeFilter(QString header, int lower, int higher);
     void setPlayerFilter(const QString& whiteFirst, const QString& whiteLast, const QString& blackFirst, const QString& blackLast, bool ignoreColor);
     void setDateFilter(const QDate &minDate, const QDate &maxDate);
+    // Only games whose mainline reaches the position with placement key position, see
+    // BitboardPosition::placementKey()
+    void setPositionFilter(quint64 position);
+    // Looks the position filter up again, e.g. after the source model got its index
+    void positionIndexChanged();
 
     void resetFilters();
 
@@ -22,6 +42,18 @@ protected:
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
 
 private:
+    const DatabaseViewerModel *games() const { return static_cast<const DatabaseViewerModel*>(sourceModel()); }
+
+    DatabaseFilterPlan compile() const;
+    // Compiles the filters and filters the table with them, on a worker thread for large tables
+    void refilter();
+    void applyPlan(const DatabaseFilterPlan &plan, std::vector<quint64> accepted, qsizetype acceptedRows);
+    void dropAccepted();
+    bool reachesPosition(int sourceRow) const;
+    // Keys of a column of the source model, built the first time it is sorted by
+    const DatabaseSortKeys &sortKeys(int column) const;
+    void dropSortKeys();
+
     QMap<QString, QRegularExpression> textFilters;
     QMap<QString, QPair<int,int>> rangeFilters;
 
@@ -32,7 +64,28 @@ private:
     bool mIgnoreColour = false;
     bool mHasPlayerFilter = false;
     bool mHasDateFilter = false;
-    
+
+    // rows reaching the position are read from the position index of the source model, it is
+    // looked up once for the first mPositionRowCount rows and per row for the others
+    bool mHasPositionFilter = false;
+    quint64 mPosition = 0;
+    std::vector<quint64> mPositionRows;
+    qsizetype mPositionRowCount = 0;
+
+    // keys of the sorted column; rows added later get theirs when they are first compared
+    mutable DatabaseSortKeys mSortKeys;
+    mutable int mSortKeysColumn = -1;
+
+    // compiled plan, and which of the first mAcceptedRows rows it accepts; rows after them are
+    // checked one by one as they are added
+    DatabaseFilterPlan mPlan;
+    std::vector<quint64> mAccepted;
+    qsizetype mAcceptedRows = 0;
+    // the latest run; earlier runs are asked to stop and finish on their own
+    QPointer<QThread> mFilterThread;
+    QList<QPointer<QThread>> mStoppingThreads;
+    // results of a run are dropped when the filters or rows changed while it was running
+    int mGeneration = 0;
 };
 
 #endif // DATABASEFILTERPROXYMODEL_H
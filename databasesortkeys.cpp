@@ -0,0 +1,132 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "databasesortkeys.h"
+#include "databaseviewermodel.h"
+#include "parallel.h"
+
+#include <numeric>
+
+void DatabaseSortKeys::build(const HeaderStore &store, const QString &header, Qt::CaseSensitivity cs)
+{
+    m_header = header;
+    m_tag = DatabaseViewerModel::columnTag(header);
+    m_caseSensitivity = cs;
+    m_column = store.column(m_tag);
+
+    static const QStringList numericHeaders {"Number", "#", "Elo", "Move", "Moves"};
+    if (numericHeaders.contains(header)) m_source = Number;
+    else if (m_tag == "WhiteElo") m_source = WhiteElo;
+    else if (m_tag == "BlackElo") m_source = BlackElo;
+    else if (m_tag == "Date") m_source = Date;
+    else if (m_tag == "Result") m_source = Result;
+    else m_source = Text;
+
+    rankTexts(store);
+    m_keys.clear();
+    appendKeys(store, 0);
+}
+
+bool DatabaseSortKeys::hasNewTexts(const HeaderStore &store) const
+{
+    if (store.column(m_tag) != m_column) return true;
+    return m_column >= 0 && static_cast<size_t>(store.dictionary(m_column).size()) + 1 != m_rankOfId.size();
+}
+
+void DatabaseSortKeys::update(const HeaderStore &store)
+{
+    if (hasNewTexts(store) || store.size() < size()) {
+        build(store, m_header, m_caseSensitivity);
+        return;
+    }
+    appendKeys(store, size());
+}
+
+void DatabaseSortKeys::replace(const HeaderStore &store, qsizetype first, qsizetype last)
+{
+    if (m_header.isEmpty()) return;
+    if (hasNewTexts(store) || store.size() < size()) {
+        build(store, m_header, m_caseSensitivity);
+        return;
+    }
+    for (qsizetype game = first; game <= last && game < size(); game++) m_keys[game] = keyOf(store, game);
+}
+
+void DatabaseSortKeys::clear()
+{
+    m_header.clear();
+    m_tag.clear();
+    m_column = -1;
+    m_rankOfId.clear();
+    m_keys.clear();
+}
+
+void DatabaseSortKeys::rankTexts(const HeaderStore &store)
+{
+    // the dictionary of the column, then for results the texts the result column holds as integers
+    std::vector<QString> texts;
+    if (m_column >= 0) {
+        const QStringList &dictionary = store.dictionary(m_column);
+        texts.assign(dictionary.begin(), dictionary.end());
+    }
+    const size_t dictionarySize = texts.size();
+    if (m_source == Result) {
+        for (int result = HeaderStore::NoResult; result <= HeaderStore::Unfinished; result++) {
+            texts.push_back(HeaderStore::resultText(static_cast<HeaderStore::Result>(result)));
+        }
+    }
+
+    std::vector<quint32> order(texts.size());
+    std::iota(order.begin(), order.end(), 0);
+    parallelSort(order.begin(), order.end(), [&](quint32 a, quint32 b) {
+        return QString::compare(texts[a], texts[b], m_caseSensitivity) < 0;
+    });
+
+    // texts that compare equal share a rank, a missing text ranks as an empty one
+    std::vector<quint32> rankOfText(texts.size());
+    quint32 rank = 0;
+    QString previous;
+    for (quint32 text : order) {
+        if (QString::compare(texts[text], previous, m_caseSensitivity) != 0) {
+            rank++;
+            previous = texts[text];
+        }
+        rankOfText[text] = rank;
+    }
+
+    m_rankOfId.assign(dictionarySize + 1, 0);
+    for (size_t id = 1; id <= dictionarySize; id++) m_rankOfId[id] = rankOfText[id - 1];
+    for (int result = HeaderStore::NoResult; result <= HeaderStore::Unfinished; result++) {
+        m_rankOfResult[result] = m_source == Result ? rankOfText[dictionarySize + result] : 0;
+    }
+}
+
+quint64 DatabaseSortKeys::keyOf(const HeaderStore &store, qsizetype game) const
+{
+    // the integer of a cell in the high half, the rank of its text in the low half
+    if (m_source == Number) {
+        const quint32 number = static_cast<quint32>(DatabaseViewerModel::cellNumber(store, static_cast<int>(game), m_header));
+        return static_cast<quint64>(number ^ 0x80000000u) << 32;
+    }
+
+    const quint32 id = m_column >= 0 ? store.valueId(game, m_column) : 0;
+    quint32 rank = id < m_rankOfId.size() ? m_rankOfId[id] : 0;
+    quint32 value = 0;
+    switch (m_source) {
+    case WhiteElo: value = static_cast<quint32>(store.whiteElo(game)); break;
+    case BlackElo: value = static_cast<quint32>(store.blackElo(game)); break;
+    case Date: value = store.date(game); break;
+    case Result: if (!id) rank = m_rankOfResult[store.result(game)]; break;
+    default: break;
+    }
+    return (static_cast<quint64>(value) << 32) | rank;
+}
+
+void DatabaseSortKeys::appendKeys(const HeaderStore &store, qsizetype first)
+{
+    m_keys.resize(static_cast<size_t>(store.size()));
+    parallelForChunks(store.size() - first, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype game = first + begin; game < first + end; ++game) m_keys[game] = keyOf(store, game);
+    }, 1024);
+}
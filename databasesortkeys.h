@@ -0,0 +1,55 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef DATABASESORTKEYS_H
+#define DATABASESORTKEYS_H
+
+#include <QString>
+
+#include <vector>
+
+#include "headerstore.h"
+
+// Sort keys of one column of a game list, so sorting compares two integers instead of two cell
+// texts. Ratings, move counts and dates are keyed by their integers; texts by their rank among the
+// distinct texts of the column, which are sorted once on all cores
+class DatabaseSortKeys
+{
+public:
+    const QString &header() const { return m_header; }
+    Qt::CaseSensitivity caseSensitivity() const { return m_caseSensitivity; }
+    qsizetype size() const { return static_cast<qsizetype>(m_keys.size()); }
+    // Games with equal cells have equal keys
+    quint64 key(qsizetype game) const { return m_keys[game]; }
+
+    // Keys of the column named header over the games of store, see DatabaseViewerModel::columnTag()
+    void build(const HeaderStore &store, const QString &header, Qt::CaseSensitivity cs);
+    // Adds the keys of games appended to store since it was built, or builds every key again when
+    // they brought texts without a rank
+    void update(const HeaderStore &store);
+    // Keys of games [first, last] after their tags were replaced
+    void replace(const HeaderStore &store, qsizetype first, qsizetype last);
+    void clear();
+
+private:
+    enum Source { Number, WhiteElo, BlackElo, Date, Result, Text };
+
+    bool hasNewTexts(const HeaderStore &store) const;
+    void rankTexts(const HeaderStore &store);
+    quint64 keyOf(const HeaderStore &store, qsizetype game) const;
+    void appendKeys(const HeaderStore &store, qsizetype first);
+
+    QString m_header;
+    QString m_tag;
+    Qt::CaseSensitivity m_caseSensitivity = Qt::CaseSensitive;
+    Source m_source = Text;
+    int m_column = -1;
+    // rank of each dictionary id of the column, ids the text column does not have yet are ranked
+    // when the keys are built again
+    std::vector<quint32> m_rankOfId;
+    quint32 m_rankOfResult[HeaderStore::Unfinished + 1] = {};
+    std::vector<quint64> m_keys;
+};
+
+#endif // DATABASESORTKEYS_H
@@ -15,10 +15,15 @@ March 18, 2025 - Program Creation
 #include "chesstabhost.h"
 #include "pgngame.h"
 #include "draggablecheckbox.h"
+#include "fastchessposition.h"
+#include "parallel.h"
+#include "pgnindex.h"
 
 
-#include <fstream>
 #include <vector>
+#include <limits>
+#include <algorithm>
+#include <iterator>
 #include <QResizeEvent>
 #include <QFile>
 #include <QMenu>
@@ -69,8 +74,8 @@ DatabaseViewer::DatabaseViewer(QString filePath, QWidget *parent)
 
     // set preview to a placeholder game (warms-up QML, stopping the window from blinking when a game is previewed)
     ChessPosition startPos;
-    QSharedPointer<NotationMove> rootMove(new NotationMove("", startPos));
-    rootMove->m_position->setBoardData(convertFenToBoardData(rootMove->FEN));
+    NotationMovePtr rootMove = NotationMove::create("", startPos);
+    rootMove->m_position.setBoardData(convertFenToBoardData(rootMove->FEN));
     PGNGame game;
     ChessGameWindow *embed = new ChessGameWindow(this, game);
     embed->previewSetup();
@@ -131,6 +136,10 @@ DatabaseViewer::DatabaseViewer(QString filePath, QWidget *parent)
     connect(dbView->selectionModel(), &QItemSelectionModel::currentRowChanged, this, &DatabaseViewer::onSingleSelected);
     connect(dbView, &QWidget::customContextMenuRequested, this, &DatabaseViewer::onContextMenu);
     connect(header, &QHeaderView::customContextMenuRequested, this, &DatabaseViewer::onHeaderContextMenu);
+    connect(mCancelImportButton, &QPushButton::clicked, this, [this]() {
+        if (m_importThread) m_importThread->requestInterruption();
+        mCancelImportButton->setEnabled(false);
+    });
 
     //save columns ratios 300ms after editing
     mSaveTimer = new QTimer(this);
@@ -159,6 +168,20 @@ void DatabaseViewer::setupUI()
     QWidget* spacer = new QWidget();
     spacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
     toolbar->addWidget(spacer);
+
+    // import status, shown while the file is read in the background
+    QWidget* importStatus = new QWidget(this);
+    QHBoxLayout* importLayout = new QHBoxLayout(importStatus);
+    importLayout->setContentsMargins(0, 0, 0, 0);
+    mImportLabel = new QLabel(tr("Importing..."), importStatus);
+    mImportProgress = new QProgressBar(importStatus);
+    mImportProgress->setFixedWidth(200);
+    mCancelImportButton = new QPushButton(tr("Cancel"), importStatus);
+    importLayout->addWidget(mImportLabel);
+    importLayout->addWidget(mImportProgress);
+    importLayout->addWidget(mCancelImportButton);
+    mImportAction = toolbar->addWidget(importStatus);
+    mImportAction->setVisible(false);
     
     contentLayout = new QSplitter(Qt::Horizontal, this);
     
@@ -181,6 +204,10 @@ void DatabaseViewer::setupUI()
 // Destructor
 DatabaseViewer::~DatabaseViewer()
 {
+    if (m_importThread) {
+        m_importThread->requestInterruption();
+        m_importThread->wait();
+    }
 }
 
 // Window resize event handler
@@ -270,6 +297,7 @@ void DatabaseViewer::filter(){
         
         if(filters.movesCheck) proxyModel->setRangeFilter("Moves", filters.movesMin, filters.movesMax);
         if(filters.dateCheck) proxyModel->setDateFilter(filters.dateMin, filters.dateMax);
+        if(filters.positionCheck) proxyModel->setPositionFilter(filters.zobrist);
 
         
     }
@@ -289,68 +317,187 @@ QString findTag(const QVector<QPair<QString,QString>>& hdr, const QString& tag,
 }
 
 void DatabaseViewer::addGame(){
+    if (!m_importComplete) return;
     PGNGame game; 
     int row = dbModel->rowCount();
     game.dbIndex = row;
     game.isParsed = true;
     game.headerInfo.push_back({QString("#"), QString::number(row+1)});
-    dbModel->insertRows(row, 1);
     dbModel->addGame(game);
 
-    for (int i = 0; i < dbModel->columnCount(); i++) {
-        QString tag = dbModel->headerData(i, Qt::Horizontal, Qt::DisplayRole).toString();
-        QString value = findTag(game.headerInfo, tag, "");
-        QModelIndex idx = dbModel->index(row, i);
-        dbModel->setData(idx, value);
-    }
-
     QModelIndex sourceIndex = dbModel->index(row, 0);
     QModelIndex proxyIndex = proxyModel->mapFromSource(sourceIndex);
     onDoubleSelected(proxyIndex);
 }
 
+// Games parsed or decoded per step of an import, each step is added to the table in one insertion
+static const qsizetype IMPORT_BATCH = 16384;
+
 // Adds game to database given PGN
 void DatabaseViewer::importPGN()
 {
-    std::ifstream file(m_filePath.toStdString());
-    if(file.fail()) return;
-
-    // parse PGN and get headers
-    StreamParser parser(file);
-    std::vector<PGNGame> database = parser.parseDatabase();
-
-    // iterate through parsed pgn
-    for(auto &game: database){
-        if(game.headerInfo.size() > 0){
-            // add to model
-            int row = dbModel->rowCount();
-            game.dbIndex = row;
-            dbModel->insertRow(row);
-            dbModel->addGame(game);
-
-            for (int i = 0; i < dbModel->columnCount(); i++) {
-                QString tag = dbModel->headerData(i, Qt::Horizontal, Qt::DisplayRole).toString();
-                QModelIndex idx = dbModel->index(row, i);
+    if (m_importThread) return;
+
+    dbModel->clearGames();
+    m_importComplete = false;
+    m_savePending = false;
+    mImportLabel->setText(tr("Importing..."));
+    mImportProgress->setRange(0, 0);
+    mImportProgress->show();
+    mCancelImportButton->setEnabled(true);
+    mCancelImportButton->show();
+    mImportAction->setVisible(true);
+
+    // the table is served from the sidecar index; it is rebuilt when the file changed since it was
+    // last imported, movetext stays in the mapped file until a game is opened
+    const QString path = m_filePath;
+    m_importThread = QThread::create([this, path]() {
+        QThread *thread = QThread::currentThread();
+        StreamParser parser(path);
+        const QSharedPointer<PGNFile> file = parser.file();
+        const qint64 total = static_cast<qint64>(file->view().size());
+        // chunks are queued to the table in order, they are dropped if the viewer is closed first
+        auto addChunk = [this, total](std::vector<PGNGameRecord> records, qsizetype firstRecord) {
+            const PGNSpan &last = records.back().bodySpan;
+            qint64 bytesRead = last.offset + last.length;
+            QMetaObject::invokeMethod(this, [this, records = std::move(records), firstRecord, bytesRead, total]() {
+                dbModel->appendRecords(records, firstRecord);
+                setImportProgress(bytesRead, total);
+            }, Qt::QueuedConnection);
+        };
+
+        QSharedPointer<PGNIndex> index = QSharedPointer<PGNIndex>::create(path);
+        if (index->matches(*file)) {
+            QMetaObject::invokeMethod(this, [this, index, file]() { dbModel->setIndex(index, file); }, Qt::QueuedConnection);
+            const qsizetype count = index->size();
+            qsizetype first = 0;
+            for (; first < count && !thread->isInterruptionRequested(); first += IMPORT_BATCH) {
+                std::vector<PGNGameRecord> records(static_cast<size_t>(qMin(IMPORT_BATCH, count - first)));
+                parallelForChunks(static_cast<qsizetype>(records.size()), [&](qsizetype begin, qsizetype end) {
+                    for (qsizetype i = begin; i < end; ++i) records[i] = index->record(first + i);
+                });
+                addChunk(std::move(records), first);
+            }
+            const bool complete = first >= count;
+            QMetaObject::invokeMethod(this, [this, complete]() { finishImport(complete, 0, true); }, Qt::QueuedConnection);
+            return;
+        }
 
+        const std::vector<PGNSpan> spans = parser.findGames();
+        const qsizetype count = static_cast<qsizetype>(spans.size());
+        // each batch is encoded into the index as it is read, the records themselves go to the table
+        PGNIndex::Builder builder(path, *file);
+        qsizetype imported = 0;
+        qsizetype skipped = 0;
+        qsizetype first = 0;
+        for (; first < count && !thread->isInterruptionRequested(); first += IMPORT_BATCH) {
+            std::vector<PGNGameRecord> records(static_cast<size_t>(qMin(IMPORT_BATCH, count - first)));
+            std::vector<QVector<quint64>> reached(records.size());
+            // mainline lengths and positions from the fast SAN decoder, replayed on all cores; no notation tree is built on import
+            parallelForChunks(static_cast<qsizetype>(records.size()), [&](qsizetype begin, qsizetype end) {
+                for (qsizetype i = begin; i < end; ++i) {
+                    records[i] = parser.parseGame(spans[first + i]);
+                    // a game set up from a FEN tag is replayed from it; one whose FEN cannot be read has no
+                    // positions and an unknown length
+                    BitboardPosition start;
+                    if (!gameStartPosition(records[i].headerInfo, start)) {
+                        records[i].plyCount = -1;
+                        continue;
+                    }
+                    QVector<quint64> &hashes = reached[i];
+                    records[i].plyCount = replayMainline(start, file->view(records[i].bodySpan), std::numeric_limits<int>::max(), &hashes,
+                                                         nullptr, ReplayKey::Placement);
+                    std::sort(hashes.begin(), hashes.end());
+                    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+                }
+            });
 
-                QString value;
-                if(tag == "Moves") value = "N/A";
-                else value = findTag(game.headerInfo, tag, "");
-                dbModel->setData(idx, value);
+            auto noHeaders = [](const PGNGameRecord &record) { return record.headerInfo.isEmpty(); };
+            if (std::any_of(records.begin(), records.end(), noHeaders)) {
+                size_t kept = 0;
+                for (size_t i = 0; i < records.size(); i++) {
+                    if (noHeaders(records[i])) continue;
+                    records[kept] = std::move(records[i]);
+                    reached[kept] = std::move(reached[i]);
+                    kept++;
+                }
+                skipped += static_cast<qsizetype>(records.size() - kept);
+                records.resize(kept);
+                reached.resize(kept);
             }
-            
+            if (records.empty()) continue;
 
-            //# column
-            dbModel->setData(dbModel->index(row, 0), row+1);
-        } else {
-            qDebug() << "Error: no game found!";
+            builder.add(records, reached);
+            const qsizetype firstRecord = imported;
+            imported += static_cast<qsizetype>(records.size());
+            addChunk(std::move(records), firstRecord);
         }
+        const bool complete = first >= count;
+
+        // a cancelled import keeps the games read so far in memory, it is never written as the file's index
+        const bool saved = complete && builder.write();
+        // a database in a read only folder keeps its index in memory and is parsed again next time
+        if (saved) index = QSharedPointer<PGNIndex>::create(path);
+        else index = QSharedPointer<PGNIndex>::create(path, builder.contents());
+        const bool indexSaved = saved || !complete;
+        QMetaObject::invokeMethod(this, [this, index, file, complete, skipped, indexSaved]() {
+            dbModel->setIndex(index, file);
+            finishImport(complete, skipped, indexSaved);
+        }, Qt::QueuedConnection);
+    });
+
+    connect(m_importThread, &QThread::finished, m_importThread, &QObject::deleteLater);
+    m_importThread->start();
+}
+
+void DatabaseViewer::setImportProgress(qint64 bytesRead, qint64 total)
+{
+    if (total > 0) {
+        int scaled = int((double(bytesRead) / double(total)) * 1000.0);
+        mImportProgress->setRange(0, 1000);
+        mImportProgress->setValue(qBound(0, scaled, 1000));
+    }
+}
+
+void DatabaseViewer::finishImport(bool complete, qsizetype skipped, bool indexSaved)
+{
+    m_importComplete = complete;
+    proxyModel->positionIndexChanged();
+    if (complete && m_savePending) exportPGN();
+    m_savePending = false;
+
+    QStringList notes;
+    if (skipped > 0) notes << tr("%1 games without tags were skipped").arg(skipped);
+    if (!indexSaved) notes << tr("the index could not be saved, the file is parsed again next time");
+    if (complete && notes.isEmpty()) {
+        mImportAction->setVisible(false);
+        return;
     }
 
+    if (complete) notes.prepend(tr("Imported %1 games").arg(dbModel->rowCount()));
+    // the games read so far can be browsed, but saving them would drop the rest of the file
+    else notes.prepend(tr("Import cancelled after %1 games, changes are not saved").arg(dbModel->rowCount()));
+    mImportLabel->setText(notes.join("; "));
+    mImportProgress->hide();
+    mCancelImportButton->hide();
 }
 
 void DatabaseViewer::exportPGN()
 {
+    if (!m_importComplete) {
+        // saving now would drop the games that are not in the table
+        if (m_importThread) {
+            m_savePending = true;
+            mImportLabel->setText(tr("Importing... changes are saved once all games are imported"));
+        } else {
+            mImportLabel->setText(tr("Import cancelled after %1 games, changes are not saved").arg(dbModel->rowCount()));
+        }
+        mImportAction->setVisible(true);
+        return;
+    }
+
+    // the file is about to be replaced, so every game must own its movetext before the mapping goes away
+    dbModel->loadAllGames();
     QVector<PGNGame> database;
     for (int i = 0; i < dbModel->rowCount(); ++i){
         database.append(dbModel->getGame(i));
@@ -367,6 +514,7 @@ void DatabaseViewer::onPGNGameUpdated(PGNGame &game)
 
     PGNGame &dbGame = dbModel->getGame(game.dbIndex);
     dbGame.bodyText = game.bodyText;
+    dbGame.source.reset();
     dbGame.headerInfo = game.headerInfo;
     dbGame.rootMove = game.rootMove;
 
@@ -378,17 +526,7 @@ void DatabaseViewer::onPGNGameUpdated(PGNGame &game)
         }
     }
 
-    for (int i = 0; i < game.headerInfo.size(); i++) {
-        const auto &kv = game.headerInfo[i];
-        int col = dbModel->headerIndex(kv.first);
-        if (col < 0) continue;
-        QModelIndex idx = dbModel->index(game.dbIndex, col);
-        dbModel->setData(idx, kv.second, Qt::EditRole);
-    }
-
-    QModelIndex top = dbModel->index(game.dbIndex, 0);
-    QModelIndex bot = dbModel->index(game.dbIndex, dbModel->columnCount() - 1);
-    emit dbModel->dataChanged(top, bot);
+    dbModel->gameChanged(game.dbIndex, true);
 
     exportPGN();
 }
@@ -402,7 +540,9 @@ void DatabaseViewer::onDoubleSelected(const QModelIndex &proxyIndex) {
     // init game window requirements
     QModelIndex sourceIndex = proxyModel->mapToSource(proxyIndex);
     int row = sourceIndex.row();
+    if (!dbModel->hasGame(row)) return;
     PGNGame &dbGame = dbModel->getGame(row);
+    dbGame.loadBody();
     PGNGame game;
     // copy game to allow user to make temporary changes
     game.copyFrom(dbGame);
@@ -455,7 +595,7 @@ void clearPreview(QWidget* container) {
 void DatabaseViewer::onContextMenu(const QPoint &pos)
 {
     QModelIndex proxyIndex = dbView->indexAt(pos);
-    if (!proxyIndex.isValid()) return;
+    if (!proxyIndex.isValid() || !m_importComplete) return;
 
     QMenu menu(this);
     QAction *del = menu.addAction(tr("Delete Game"));
@@ -468,16 +608,17 @@ void DatabaseViewer::onContextMenu(const QPoint &pos)
             proxyModel->invalidate();
             dbView->clearSelection();
 
+            // games that were never opened get their index when they are created
             for (int i = row; i < dbModel->rowCount(); i++){
-                PGNGame &dbGame = dbModel->getGame(i);
-                dbGame.dbIndex--;
-                for (auto &[tag, value]: dbGame.headerInfo){
+                PGNGame *dbGame = dbModel->loadedGame(i);
+                if (!dbGame) continue;
+                dbGame->dbIndex--;
+                for (auto &[tag, value]: dbGame->headerInfo){
                     if (tag == "Number"){
                         value = QString::number(value.toInt()+1);
                     }
                 }
-                QModelIndex idx = dbModel->index(i, 0);
-                dbModel->setData(idx, i+1);
+                dbModel->gameChanged(i);
             }
         }
 
@@ -638,8 +779,11 @@ void DatabaseViewer::onSingleSelected(const QModelIndex &proxyIndex, const QMode
     if (!proxyIndex.isValid() || proxyIndex.row() < 0) return;
     QModelIndex sourceIndex = proxyModel->mapToSource(proxyIndex);
     int row = sourceIndex.row();
+    // games of a file that is still being parsed can be opened once its index is built
+    if (!dbModel->hasGame(row)) return;
     PGNGame &dbGame = dbModel->getGame(row);
     if (!dbGame.isParsed){
+        dbGame.loadBody();
         parseBodyText(dbGame.bodyText, dbGame.rootMove);
         dbGame.isParsed = true;
     }
@@ -17,6 +17,10 @@
 #include <QTimer>
 #include <QPushButton>
 #include <QSplitter>
+#include <QProgressBar>
+#include <QLabel>
+#include <QThread>
+#include <QPointer>
 
 class ChessTabHost;
 
@@ -34,6 +38,7 @@ public:
     explicit DatabaseViewer(QString filePath, QWidget *parent = nullptr);
     ~DatabaseViewer();
 
+    // Reads the games of the file on a worker thread, rows are added to the table as they are read
     void importPGN();
     void exportPGN();
     void setWindowTitle(QString text);
@@ -59,12 +64,20 @@ private:
     void setupUI();  
     void resizeTable();
     void resizeSplitter();
+    void setImportProgress(qint64 bytesRead, qint64 total);
+    // skipped counts games dropped for having no tags, indexSaved is false when a complete import
+    // could not write its sidecar index
+    void finishImport(bool complete, qsizetype skipped, bool indexSaved);
 
     // UI 
     QAction* mFilterAction;
     QAction* mAddGameAction;
     QSplitter* contentLayout;
     QWidget* gamePreview;
+    QAction* mImportAction;
+    QLabel* mImportLabel;
+    QProgressBar* mImportProgress;
+    QPushButton* mCancelImportButton;
 
     ChessGameWindow *m_embed;
     QTableView *dbView;
@@ -78,6 +91,11 @@ private:
     ChessTabHost *host;
 
     QString m_filePath;
+    QPointer<QThread> m_importThread;
+    // false while importing and after a cancelled import, the table then lacks games of the file
+    bool m_importComplete = false;
+    // an edit made while importing, saved once the import completes
+    bool m_savePending = false;
 };
 
 #endif // DATABASEVIEWER_H
@@ -1,13 +1,28 @@
 #include "databaseviewermodel.h"
 #include "streamparser.h"
+#include "fastchessposition.h"
+#include "parallel.h"
 
-DatabaseViewerModel::DatabaseViewerModel(QObject *parent): QAbstractItemModel{parent} {
+#include <limits>
+
+// Replays the mainline of a game that is not in the index from its start position, like the
+// importer; a game whose FEN tag cannot be read reaches no position
+static bool mainlineReaches(const PGNGame &game, quint64 position)
+{
+    BitboardPosition start;
+    if (!gameStartPosition(game.headerInfo, start)) return false;
+    QVector<quint64> hashes;
+    replayMainline(start, QStringView(game.body()), std::numeric_limits<int>::max(), &hashes, nullptr, ReplayKey::Placement);
+    return hashes.contains(position);
+}
+
+DatabaseViewerModel::DatabaseViewerModel(QObject *parent): QAbstractItemModel{parent}, mHeaderStore(new HeaderStore) {
     mHeaders << "#" << "White" << "wElo" << "Black" << "bElo" << "Result" << "Moves" << "Event" << "Date";
 }
 
 // Returns the number of rows
 int DatabaseViewerModel::rowCount(const QModelIndex &parent) const {
-    return static_cast<int>(mData.size());
+    return static_cast<int>(mRows.size());
 }
 
 // Returns the number of columns
@@ -15,6 +30,33 @@ int DatabaseViewerModel::columnCount(const QModelIndex &parent) const {
     return mHeaders.size();
 }
 
+QString DatabaseViewerModel::columnTag(const QString &header)
+{
+    //custom ones
+    if (header == "wElo") return QStringLiteral("WhiteElo");
+    if (header == "bElo") return QStringLiteral("BlackElo");
+    return header;
+}
+
+QString DatabaseViewerModel::cellText(const HeaderStore &store, int row, const QString &header)
+{
+    if (header == "#") return QString::number(row + 1);
+    if (header == "Moves") {
+        int plyCount = store.plyCount(row);
+        return plyCount < 0 ? QString() : QString::number((plyCount + 1) / 2);
+    }
+    return store.value(row, columnTag(header));
+}
+
+int DatabaseViewerModel::cellNumber(const HeaderStore &store, int row, const QString &header)
+{
+    if (header == "#") return row + 1;
+    if (header == "Moves") return qMax(0, (store.plyCount(row) + 1) / 2);
+    // ratings that are not plain numbers are only in the text column
+    if (header == "wElo" && store.whiteElo(row)) return store.whiteElo(row);
+    if (header == "bElo" && store.blackElo(row)) return store.blackElo(row);
+    return cellText(store, row, header).toInt();
+}
 
 // Returns the values in the model
 QVariant DatabaseViewerModel::data(const QModelIndex &index, int role) const {
@@ -24,8 +66,10 @@ QVariant DatabaseViewerModel::data(const QModelIndex &index, int role) const {
     if (role == Qt::DisplayRole) {
         int row = index.row();
         int col = index.column();
-        if (row >= 0 && row < rowCount() && col >= 0 && col < columnCount())
-            return mData[row][col];
+        if (row < 0 || row >= rowCount() || col < 0 || col >= columnCount())
+            return QVariant();
+
+        return cellText(*mHeaderStore, row, mHeaders[col]);
     }
 
     else if(role == Qt::TextAlignmentRole){
@@ -49,43 +93,35 @@ QModelIndex DatabaseViewerModel::parent(const QModelIndex &child) const{
     return QModelIndex();
 }
 
-// Inserts rows given an index and a row count
-bool DatabaseViewerModel::insertRows(int row, int count, const QModelIndex &parent) {
-    if (row < 0 || row > static_cast<int>(mData.size()))
-        return false;
-
-    beginInsertRows(parent, row, row + count - 1);
-
-    for (int i = 0; i < count; ++i) {
-        std::vector<QString> newRow(columnCount());
-        if (row == static_cast<int>(mData.size())) {
-            mData.push_back(newRow);
-        } else {
-            mData.insert(mData.begin() + row, newRow);
-        }
-    }
-
-    endInsertRows();
-    return true;
+void DatabaseViewerModel::clearGames()
+{
+    beginResetModel();
+    mRows.clear();
+    // a new store, so one still read by a filter run is not copied only to be emptied
+    mHeaderStore.reset(new HeaderStore);
+    mIndex.reset();
+    mFile.reset();
+    endResetModel();
 }
 
-// Changes the model data
-bool DatabaseViewerModel::setData(const QModelIndex &index, const QVariant &value, int role)
+void DatabaseViewerModel::setIndex(const QSharedPointer<const PGNIndex> &index, const QSharedPointer<PGNFile> &file)
 {
-    if (!index.isValid() || role != Qt::EditRole)
-        return false;
-
-    int row = index.row();
-    int col = index.column();
-
-    if (row < 0 || row >= rowCount() || col < 0 || col >= columnCount())
-        return false;
-
-    mData[row][col] = value.toString();
-
-    emit dataChanged(index, index);
+    mIndex = index;
+    mFile = file;
+}
 
-    return true;
+void DatabaseViewerModel::appendRecords(const std::vector<PGNGameRecord> &records, qsizetype firstRecord)
+{
+    if (records.empty()) return;
+    int row = rowCount();
+    beginInsertRows(QModelIndex(), row, row + static_cast<int>(records.size()) - 1);
+    for (size_t i = 0; i < records.size(); i++) {
+        Row entry;
+        entry.record = firstRecord + static_cast<qsizetype>(i);
+        mRows.push_back(entry);
+    }
+    mHeaderStore->append(records, 0, static_cast<qsizetype>(records.size()));
+    endInsertRows();
 }
 
 // Returns the header data
@@ -105,7 +141,7 @@ QVariant DatabaseViewerModel::headerData(int section, Qt::Orientation orientatio
     return QVariant();
 }
 
-int DatabaseViewerModel::headerIndex(const QString& header){
+int DatabaseViewerModel::headerIndex(const QString& header) const{
     return mHeaders.indexOf(header);
 }
 
@@ -114,9 +150,6 @@ void DatabaseViewerModel::addHeader(const QString& header){
         int newCol = mHeaders.size();
         beginInsertColumns(QModelIndex(), newCol, newCol);
         mHeaders << header;
-        for(auto &row: mData){
-            row.push_back("");
-        }
         endInsertColumns();
         emit headerDataChanged(Qt::Horizontal, mHeaders.size()-1, mHeaders.size()-1);
     }
@@ -124,47 +157,125 @@ void DatabaseViewerModel::addHeader(const QString& header){
 
 void DatabaseViewerModel::removeHeader(int headerIndex) {
     if(headerIndex < 0 || headerIndex >= mHeaders.size()) return;
-    
+
     beginRemoveColumns(QModelIndex(), headerIndex, headerIndex);
-    
+
     mHeaders.removeAt(headerIndex);
-    
-    for(auto& row : mData) {
-        if(headerIndex < static_cast<int>(row.size())) {
-            row.erase(row.begin() + headerIndex);
-        }
-    }
-    
+
     endRemoveColumns();
-    
+
     emit headerDataChanged(Qt::Horizontal, 0, columnCount() - 1);
 }
 
 
 
-void DatabaseViewerModel::addGame(const PGNGame& game)
+void DatabaseViewerModel::addGame(const PGNGame& game, int plyCount)
 {
-    mGameData.append(game);
+    int row = rowCount();
+    beginInsertRows(QModelIndex(), row, row);
+    Row entry;
+    entry.game = QSharedPointer<PGNGame>::create(game);
+    mRows.push_back(entry);
+    mHeaderStore->append(game.headerInfo, plyCount);
+    endInsertRows();
 }
 
 bool DatabaseViewerModel::removeGame(const int row, const QModelIndex &parent)
 {
-    if (row < 0 || row >= mGameData.size()){
+    if (row < 0 || row >= rowCount()){
         return false;
     }
 
     beginRemoveRows(parent, row, row);
-    mGameData.remove(row);
-    mData.erase(mData.begin() + row);
+    mRows.erase(mRows.begin() + row);
+    mHeaderStore->remove(row);
     endRemoveRows();
     return true;
 }
 
 PGNGame& DatabaseViewerModel::getGame(int row) {
-    if (row >= 0 && row < mGameData.size()){
-        return mGameData[row];
+    if (row < 0 || row >= rowCount()){
+        throw std::out_of_range("Invalid row index in getGame()");
+    }
+
+    Row &entry = mRows[row];
+    if (entry.game.isNull()) {
+        PGNGameRecord record = mIndex->record(entry.record);
+        entry.game = QSharedPointer<PGNGame>::create();
+        entry.game->headerInfo = std::move(record.headerInfo);
+        entry.game->result = std::move(record.result);
+        entry.game->source = mFile;
+        entry.game->bodySpan = record.bodySpan;
+        entry.game->dbIndex = row;
+    }
+    return *entry.game;
+}
+
+void DatabaseViewerModel::gameChanged(int row, bool movetextChanged)
+{
+    if (row < 0 || row >= rowCount() || mRows[row].game.isNull()) return;
+    if (movetextChanged) mRows[row].record = -1;
+    mHeaderStore->replace(row, mRows[row].game->headerInfo);
+    emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+}
+
+std::vector<quint64> DatabaseViewerModel::rowsReaching(quint64 position) const
+{
+    std::vector<bool> indexGames;
+    if (!mIndex.isNull()) {
+        indexGames.resize(static_cast<size_t>(mIndex->size()));
+        for (quint32 game : mIndex->gamesReaching(position)) {
+            if (game < indexGames.size()) indexGames[game] = true;
+        }
     }
-    throw std::out_of_range("Invalid row index in getGame()");
+
+    // each chunk writes whole words; games without an index, e.g. after saving, are replayed on all cores
+    const qsizetype count = static_cast<qsizetype>(mRows.size());
+    std::vector<quint64> rows(static_cast<size_t>((count + 63) / 64), 0);
+    parallelForChunks(static_cast<qsizetype>(rows.size()), [&](qsizetype begin, qsizetype end) {
+        for (qsizetype word = begin; word < end; ++word) {
+            quint64 bits = 0;
+            const qsizetype first = word * 64;
+            const int n = static_cast<int>(qMin<qsizetype>(64, count - first));
+            for (int bit = 0; bit < n; ++bit) {
+                const Row &entry = mRows[first + bit];
+                bool reaches;
+                if (entry.record >= 0 && !mIndex.isNull()) reaches = static_cast<size_t>(entry.record) < indexGames.size() && indexGames[entry.record];
+                else reaches = !entry.game.isNull() && mainlineReaches(*entry.game, position);
+                if (reaches) bits |= 1ULL << bit;
+            }
+            rows[word] = bits;
+        }
+    }, 16);
+    return rows;
+}
+
+bool DatabaseViewerModel::reachesPosition(int row, quint64 position) const
+{
+    if (row < 0 || row >= rowCount()) return false;
+    const Row &entry = mRows[row];
+    if (entry.record >= 0 && !mIndex.isNull()) return entry.record < mIndex->size() && mIndex->reaches(entry.record, position);
+    return !entry.game.isNull() && mainlineReaches(*entry.game, position);
+}
+
+bool DatabaseViewerModel::hasGame(int row) const
+{
+    if (row < 0 || row >= rowCount()) return false;
+    const Row &entry = mRows[row];
+    return !entry.game.isNull() || (!mIndex.isNull() && entry.record < mIndex->size());
 }
 
+PGNGame* DatabaseViewerModel::loadedGame(int row) {
+    if (row < 0 || row >= rowCount()) return nullptr;
+    return mRows[row].game.data();
+}
 
+void DatabaseViewerModel::loadAllGames()
+{
+    for (int row = 0; row < rowCount(); row++) {
+        getGame(row).loadBody();
+    }
+    // no game is decoded from the index any more, but its posting lists still hold the positions
+    // of every game whose movetext was not edited, so searches keep using them after a save
+    mFile.reset();
+}
@@ -2,11 +2,18 @@
 #define DATABASEVIEWERMODEL_H
 
 #include "pgngame.h"
+#include "pgnindex.h"
+#include "headerstore.h"
 
 #include <QAbstractItemModel>
 #include <QStringList>
+#include <QSharedPointer>
+#include <QSharedDataPointer>
 
-// DatabaseViewerModel class is a model to store game headers
+#include <vector>
+
+// DatabaseViewerModel class is a model to store game headers. Cells are read from a columnar
+// header store, a game is only created from the index for rows that are opened, edited or added
 class DatabaseViewerModel : public QAbstractItemModel
 {
 public:
@@ -22,20 +29,60 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
 
-    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
-    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    // Removes every row, the index and the file
+    void clearGames();
+    // Index the appended records refer to and the file their movetext is read from; it can be set
+    // after the records were appended, their games are only available from then on
+    void setIndex(const QSharedPointer<const PGNIndex> &index, const QSharedPointer<PGNFile> &file);
+
+    // Header tags of all rows, row i is game i
+    const HeaderStore& headerStore() const { return *mHeaderStore; }
+    // The same store shared with a reader on another thread, the model copies it before changing
+    // it while the reader still holds it
+    QSharedDataPointer<HeaderStore> sharedHeaderStore() const { return mHeaderStore; }
+    // Tag shown in a column, e.g. "WhiteElo" for "wElo"
+    static QString columnTag(const QString& header);
+    // Cell of row in the column named header of a table over store, as shown and as a number
+    static QString cellText(const HeaderStore& store, int row, const QString& header);
+    static int cellNumber(const HeaderStore& store, int row, const QString& header);
 
-    int headerIndex(const QString& header);
+    int headerIndex(const QString& header) const;
     void addHeader(const QString& header);
     void removeHeader(int headerIndex);
-    void addGame(const PGNGame& game);
+    // Appends a row for each record with one insertion, row i is game firstRecord + i of the index
+    void appendRecords(const std::vector<PGNGameRecord>& records, qsizetype firstRecord);
+    // Appends a row for game, plyCount is shown in the Moves column when known
+    void addGame(const PGNGame& game, int plyCount = -1);
     bool removeGame(const int row, const QModelIndex &parent);
+    // The game of a row, created from the index the first time it is asked for
     PGNGame& getGame(int row);
+    // True when getGame(row) can create the game of the row
+    bool hasGame(int row) const;
+    // The game of a row if it has been created, nullptr otherwise
+    PGNGame* loadedGame(int row);
+    // Updates the cells of a row after the headers of its game were changed; a game whose
+    // movetext changed is no longer looked up in the index
+    void gameChanged(int row, bool movetextChanged = false);
+    // Bit i % 64 of word i / 64 is set when the mainline of row i reaches the position with placement
+    // key position; rows of index games are read from its posting list, other games are replayed
+    std::vector<quint64> rowsReaching(quint64 position) const;
+    bool reachesPosition(int row, quint64 position) const;
+    // Creates every game with its movetext and drops the file, e.g. before the file is replaced; the
+    // index is kept for position searches
+    void loadAllGames();
 
 private:
-    std::vector<std::vector<QString>> mData;
-    QVector<PGNGame> mGameData;
+    struct Row {
+        qsizetype record = -1; // game in the index, -1 for games added afterwards
+        QSharedPointer<PGNGame> game;
+    };
+
+    std::vector<Row> mRows;
     QStringList mHeaders;
+    QSharedDataPointer<HeaderStore> mHeaderStore;
+
+    QSharedPointer<const PGNIndex> mIndex;
+    QSharedPointer<PGNFile> mFile;
 };
 
 #endif // DATABASEVIEWERMODEL_H
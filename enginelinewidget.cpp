@@ -10,7 +10,7 @@
 #include <QShowEvent>
 #include <QPalette>
 
-EngineLineWidget::EngineLineWidget(const QString &eval, const QString &pv, const QSharedPointer<NotationMove> &rootMove, QWidget *parent)
+EngineLineWidget::EngineLineWidget(const QString &eval, const QString &pv, const NotationMovePtr &rootMove, QWidget *parent)
     : QWidget(parent)
     , m_fullText(pv)
     , m_evalBtn(new QPushButton(this))
@@ -92,18 +92,18 @@ void EngineLineWidget::paintEvent(QPaintEvent *event) {
     m_arrow->show();
 
     // paint moves
-    QVector<QSharedPointer<NotationMove>> moves;
+    QVector<NotationMovePtr> moves;
     auto curMove = m_rootMove;
-    while (curMove && !curMove->m_nextMoves.isEmpty()) {
+    while (curMove && !curMove->nextMoves().isEmpty()) {
         moves.append(curMove);
-        curMove = curMove->m_nextMoves.first();
+        curMove = curMove->nextMoves().first();
     }
     m_moveSegments.clear();
     int availW = width() - x - m_arrow->width() - 8;
     for (int i = 0; i < moves.size(); ++i) {
         QString numPrefix;
-        int moveNum = moves[i]->m_position->getPlyCount()/2 + 1;
-        if (moves[i]->m_position->m_sideToMove == 'b') {
+        int moveNum = moves[i]->m_position.getPlyCount()/2 + 1;
+        if (moves[i]->m_position.sideToMove() == 'b') {
             numPrefix = QString::number(moveNum) + ".";
         } else if (moves[i]->isVarRoot) {
             numPrefix = QString::number(moveNum) + "...";
@@ -14,12 +14,12 @@ class EngineLineWidget : public QWidget {
     Q_OBJECT
 
 public:
-    explicit EngineLineWidget(const QString &eval, const QString &pv, const QSharedPointer<NotationMove>& rootMove, QWidget *parent = nullptr);
+    explicit EngineLineWidget(const QString &eval, const QString &pv, const NotationMovePtr& rootMove, QWidget *parent = nullptr);
     void updateEval(const QString &newEval);
 
 signals:
-    void moveClicked(QSharedPointer<NotationMove> &move);
-    void moveHovered(QSharedPointer<NotationMove> &move);
+    void moveClicked(NotationMovePtr &move);
+    void moveHovered(NotationMovePtr &move);
     void noHover();
 
 protected:
@@ -32,7 +32,7 @@ private slots:
     void toggleExpanded();
 
 private:
-    QSharedPointer<NotationMove> m_rootMove;
+    NotationMovePtr m_rootMove;
     QList<MoveSegment> m_moveSegments;
     MoveSegment* m_hoveredSegment = nullptr;
     PvInfo m_info;
@@ -19,15 +19,15 @@ April 11, 2025: File Creation
 #include <QApplication>
 
 
-EngineWidget::EngineWidget(const QSharedPointer<NotationMove>& move, QWidget *parent)
+EngineWidget::EngineWidget(const NotationMovePtr& move, QWidget *parent)
     : QWidget(parent),
     m_engine(new UciEngine(this)),
     m_multiPv(3),
     m_console(new QTextEdit(this)),
     m_isHovering(false),
     m_ignoreHover(false),
-    m_sideToMove(move->m_position->m_sideToMove),
-    m_currentFen(move->m_position->positionToFEN()),
+    m_sideToMove(move->m_position.sideToMove()),
+    m_currentFen(move->m_position.positionToFEN()),
     m_currentMove(move)
 {
     setAttribute(Qt::WA_Hover, true);
@@ -256,19 +256,19 @@ void EngineWidget::onConfigEngineClicked()
     QTimer::singleShot(200, this, [this](){ doPendingAnalysis(); });
 }
 
-void EngineWidget::onMoveSelected(const QSharedPointer<NotationMove>& move)
+void EngineWidget::onMoveSelected(const NotationMovePtr& move)
 {
-    if (!move.isNull() && move->m_position) {
+    if (!move.isNull()) {
         m_ignoreHover = true;
         m_isHovering = false;
-        m_sideToMove = move->m_position->m_sideToMove;
-        m_currentFen = move->m_position->positionToFEN();
+        m_sideToMove = move->m_position.sideToMove();
+        m_currentFen = move->m_position.positionToFEN();
         m_currentMove = move;
         m_debounceTimer->start();
     }
 }
 
-void EngineWidget::onEngineMoveClicked(QSharedPointer<NotationMove>& move)
+void EngineWidget::onEngineMoveClicked(NotationMovePtr& move)
 {
     emit engineMoveClicked(move);
 
@@ -282,8 +282,7 @@ void EngineWidget::onEngineMoveClicked(QSharedPointer<NotationMove>& move)
     }
     m_lineWidgets.clear();
     for (int i = 1; i <= m_multiPv; i++) {
-        ChessPosition* dummyPos = new ChessPosition;
-        auto temp = QSharedPointer<NotationMove>::create(QString(), *dummyPos);
+        auto temp = NotationMove::create(QString(), ChessPosition());
         auto *lineW = new EngineLineWidget("...", "", temp, this);
         lineW->installEventFilter(this);
         m_containerLay->addWidget(lineW);
@@ -312,8 +311,7 @@ void EngineWidget::analysePosition() {
     m_lineWidgets.clear();
 
     for (int i = 1; i <= m_multiPv; i++) {
-        ChessPosition* dummyPos = new ChessPosition;
-        auto temp = QSharedPointer<NotationMove>::create(QString(), *dummyPos);
+        auto temp = NotationMove::create(QString(), ChessPosition());
         auto *lineW = new EngineLineWidget("...", "", temp, this);
         lineW->installEventFilter(this);
         m_containerLay->addWidget(lineW);
@@ -339,7 +337,7 @@ void EngineWidget::onPvUpdate(PvInfo &info) {
     info.positive = ((m_sideToMove == 'w' && info.score >= 0) || (m_sideToMove == 'b' && info.score < 0) ? true : false);
     info.score = abs(info.score);
 
-    QSharedPointer<NotationMove> rootMove = parseEngineLine(info.pvLine, m_currentMove); // parse LAN into a notation tree
+    NotationMovePtr rootMove = parseEngineLine(info.pvLine, m_currentMove); // parse LAN into a notation tree
     QString evalTxt = (info.positive ? "" : "-") + (info.isMate ? tr("M%1").arg(info.score) : QString("%1").arg(info.score, 0, 'f', 2));
 
     if (!rootMove){
@@ -366,7 +364,7 @@ void EngineWidget::onPvUpdate(PvInfo &info) {
         double evalScore = 0.0;
         if (!info.isMate) evalScore = (info.positive ? info.score : -info.score);
         else evalScore = (info.positive ? 4.0 : -4.0);
-        m_currentMove->m_position->setEvalScore(qMax(4.0, qMin(-4.0, evalScore)));
+        m_currentMove->m_position.setEvalScore(qMax(4.0, qMin(-4.0, evalScore)));
         emit engineEvalScoreChanged(evalScore);
 
         QString bg = info.positive ? QStringLiteral("white") : QStringLiteral("#333"); //hcc
@@ -22,11 +22,11 @@ April 11, 2025: File Creation
 class EngineWidget : public QWidget {
     Q_OBJECT
 public:
-    explicit EngineWidget(const QSharedPointer<NotationMove>& move, QWidget *parent = nullptr);
+    explicit EngineWidget(const NotationMovePtr& move, QWidget *parent = nullptr);
 
 signals:
-    void engineMoveClicked(QSharedPointer<NotationMove>& move);
-    void moveHovered(QSharedPointer<NotationMove>& move);
+    void engineMoveClicked(NotationMovePtr& move);
+    void moveHovered(NotationMovePtr& move);
     void noHover();
     void engineEvalScoreChanged(double evalScore);
 
@@ -34,10 +34,10 @@ protected:
     bool eventFilter(QObject *watched, QEvent *event) override;
 
 public slots:
-    void onMoveSelected(const QSharedPointer<NotationMove>& move);
+    void onMoveSelected(const NotationMovePtr& move);
 
 private slots:
-    void onEngineMoveClicked(QSharedPointer<NotationMove>& move);
+    void onEngineMoveClicked(NotationMovePtr& move);
     void onNameReceived(const QString &name);
     void onConfigEngineClicked();
     void doPendingAnalysis();
@@ -67,7 +67,7 @@ private:
     QTextEdit *m_console;
     QString m_currentFen;
     QString m_sideToMove;
-    QSharedPointer<NotationMove> m_currentMove;
+    NotationMovePtr m_currentMove;
 
     QMap<int, EngineLineWidget*> m_lineWidgets;
 
@@ -1,5 +1,18 @@
 #include "fastchessposition.h"
-#include <QDebug>
+#include "pgntokenizer.h"
+
+static int pieceFromLetter(QChar c)
+{
+    switch (c.unicode()) {
+    case 'P': return PAWN;
+    case 'N': return KNIGHT;
+    case 'B': return BISHOP;
+    case 'R': return ROOK;
+    case 'Q': return QUEEN;
+    case 'K': return KING;
+    default: return -1;
+    }
+}
 
 FastChessPosition::FastChessPosition()
 {
@@ -8,404 +21,254 @@ FastChessPosition::FastChessPosition()
 
 void FastChessPosition::reset()
 {
-    // Set up starting position - rank 1 should be at index 0-7, rank 8 at index 56-63
-    const char startingPosition[64] = {
-        'R', 'N', 'B', 'Q', 'K', 'B', 'N', 'R',  // rank 1 (indices 0-7)
-        'P', 'P', 'P', 'P', 'P', 'P', 'P', 'P',  // rank 2 (indices 8-15)
-         0,   0,   0,   0,   0,   0,   0,   0,   // rank 3 (indices 16-23)
-         0,   0,   0,   0,   0,   0,   0,   0,   // rank 4 (indices 24-31)
-         0,   0,   0,   0,   0,   0,   0,   0,   // rank 5 (indices 32-39)
-         0,   0,   0,   0,   0,   0,   0,   0,   // rank 6 (indices 40-47)
-        'p', 'p', 'p', 'p', 'p', 'p', 'p', 'p',  // rank 7 (indices 48-55)
-        'r', 'n', 'b', 'q', 'k', 'b', 'n', 'r'   // rank 8 (indices 56-63)
-    };
-    
-    for (int i = 0; i < 64; i++) {
-        board[i] = startingPosition[i];
-    }
-    
-    whiteToMove = true;
-    whiteKingside = whiteQueenside = blackKingside = blackQueenside = true;
-    enPassantTarget = -1;  // No en passant target initially
+    m_board.setStartPosition();
 }
 
-int FastChessPosition::squareToIndex(const QString& square)
+bool FastChessPosition::setFen(const QString& fen)
 {
-    if (square.length() != 2) return -1;
-    int file = square[0].toLatin1() - 'a';
-    int rank = square[1].toLatin1() - '1';
-    if (file < 0 || file > 7 || rank < 0 || rank > 7) return -1;
-    return rank * 8 + file;
+    QByteArray latin1 = fen.toLatin1();
+    return m_board.setFen(std::string_view(latin1.constData(), latin1.size()));
 }
 
-QString FastChessPosition::indexToSquare(int index)
+Move FastChessPosition::sanToMove(QStringView san) const
 {
-    if (index < 0 || index > 63) return "";
-    int file = index % 8;
-    int rank = index / 8;
-    return QString(QChar('a' + file)) + QString::number(rank + 1);
+    // Remove check/checkmate indicators and move annotations
+    int end = san.size();
+    while (end > 0 && (san[end-1] == '+' || san[end-1] == '#' || san[end-1] == '!' || san[end-1] == '?')) end--;
+    san = san.left(end);
+    if (end < 2) return NULL_MOVE;
+
+    MoveList legalMoves;
+    m_board.generateLegalMoves(legalMoves);
+
+    // Handle castling
+    bool kingSide = (san == QLatin1String("O-O") || san == QLatin1String("0-0"));
+    bool queenSide = (san == QLatin1String("O-O-O") || san == QLatin1String("0-0-0"));
+    if (kingSide || queenSide) {
+        int king = m_board.kingSquare(m_board.sideToMove);
+        int to = king + (kingSide ? 2 : -2);
+        for (Move move : legalMoves) {
+            if (moveFrom(move) == king && moveTo(move) == to) return move;
+        }
+        return NULL_MOVE;
+    }
+
+    // Promotion piece, with or without '='
+    int promo = PAWN;
+    int last = pieceFromLetter(san[end-1]);
+    if (last > PAWN && last < KING) {
+        promo = last;
+        end--;
+        if (end > 0 && san[end-1] == '=') end--;
+    }
+
+    // Destination square is always the last two characters
+    if (end < 2) return NULL_MOVE;
+    int toCol = san[end-2].unicode() - 'a';
+    int toRank = san[end-1].unicode() - '1';
+    if (toCol < 0 || toCol > 7 || toRank < 0 || toRank > 7) return NULL_MOVE;
+    int to = squareOf(7 - toRank, toCol);
+
+    // Piece letter, pawns have none
+    int type = pieceFromLetter(san[0]);
+    int idx = 1;
+    if (type < 0) {
+        type = PAWN;
+        idx = 0;
+    }
+
+    // Disambiguation from the remaining characters, capture markers are ignored
+    int fromCol = -1, fromRow = -1;
+    for (int i = idx; i < end - 2; i++) {
+        QChar c = san[i];
+        if (c >= 'a' && c <= 'h') fromCol = c.unicode() - 'a';
+        else if (c >= '1' && c <= '8') fromRow = 8 - (c.unicode() - '0');
+    }
+
+    for (Move move : legalMoves) {
+        int from = moveFrom(move);
+        if (moveTo(move) != to || movePromotion(move) != promo) continue;
+        if (pieceType(m_board.pieceAt(from)) != type) continue;
+        if (fromCol != -1 && colOf(from) != fromCol) continue;
+        if (fromRow != -1 && rowOf(from) != fromRow) continue;
+        return move;
+    }
+    return NULL_MOVE;
 }
 
-char FastChessPosition::pieceAt(int file, int rank)
+QString FastChessPosition::algebraicToUCI(const QString& algebraicMove) const
 {
-    if (file < 0 || file > 7 || rank < 0 || rank > 7) return 0;
-    return board[rank * 8 + file];
+    Move move = sanToMove(QStringView(algebraicMove).trimmed());
+    return move == NULL_MOVE ? QString() : moveToUCI(move);
 }
 
-void FastChessPosition::setPiece(int file, int rank, char piece)
+QString FastChessPosition::moveToUCI(Move move)
 {
-    if (file >= 0 && file <= 7 && rank >= 0 && rank <= 7) {
-        board[rank * 8 + file] = piece;
-    }
+    int from = moveFrom(move), to = moveTo(move);
+    QString uci;
+    uci += QChar('a' + colOf(from));
+    uci += QChar('8' - rowOf(from));
+    uci += QChar('a' + colOf(to));
+    uci += QChar('8' - rowOf(to));
+    if (movePromotion(move) != PAWN) uci += QLatin1Char("pnbrqk"[movePromotion(move)]);
+    return uci;
 }
 
-QString FastChessPosition::algebraicToUCI(const QString& algebraicMove)
+bool FastChessPosition::makeMove(const QString& uci)
 {
-    QString move = algebraicMove.trimmed();
-    
-    // Debug output for first few moves
-    static int debugCount = 0;
-    bool shouldDebug = debugCount < 50;  // Debug first 50 moves
-    
-    if (shouldDebug) {
-        qDebug() << "Converting algebraic move:" << move;
-        debugCount++;
-    }
-    
-    // Remove check/checkmate indicators
-    if (move.endsWith('+') || move.endsWith('#')) {
-        move.chop(1);
-        if (shouldDebug) qDebug() << "  After removing check/mate:" << move;
-    }
-    
-    // Handle castling
-    if (move == "O-O") {
-        QString result = whiteToMove ? "e1g1" : "e8g8";
-        if (shouldDebug) qDebug() << "  Castling kingside:" << result;
-        return result;
-    }
-    if (move == "O-O-O") {
-        QString result = whiteToMove ? "e1c1" : "e8c8";
-        if (shouldDebug) qDebug() << "  Castling queenside:" << result;
-        return result;
-    }
-    
-    // Parse destination square (always last 2 characters)
-    if (move.length() < 2) {
-        if (shouldDebug) qDebug() << "  ERROR: Move too short";
-        return "";
-    }
-    
-    QString destSquare = move.right(2);
-    if (destSquare[0] < 'a' || destSquare[0] > 'h' || 
-        destSquare[1] < '1' || destSquare[1] > '8') {
-        if (shouldDebug) qDebug() << "  ERROR: Invalid destination square:" << destSquare;
-        return "";
+    if (uci.length() != 4 && uci.length() != 5) return false;
+
+    int fromCol = uci[0].unicode() - 'a', fromRank = uci[1].unicode() - '1';
+    int toCol = uci[2].unicode() - 'a', toRank = uci[3].unicode() - '1';
+    if (fromCol < 0 || fromCol > 7 || fromRank < 0 || fromRank > 7 ||
+        toCol < 0 || toCol > 7 || toRank < 0 || toRank > 7) {
+        return false;
     }
-    
-    if (shouldDebug) qDebug() << "  Destination square:" << destSquare;
-    
-    int toFile = destSquare[0].toLatin1() - 'a';
-    int toRank = destSquare[1].toLatin1() - '1';
-    
-    // Remove capture indicator and destination square
-    QString remaining = move;
-    remaining.remove('x');
-    remaining = remaining.left(remaining.length() - 2);
-    
-    if (shouldDebug) qDebug() << "  Remaining after parsing dest:" << remaining;
-    
-    char pieceType = 'P'; // Default to pawn
-    int fromFile = -1, fromRank = -1;
-    
-    // Parse piece type and disambiguation
-    if (!remaining.isEmpty()) {
-        int pos = 0;
-        
-        // Check if first character is a piece type
-        if (remaining[0].isUpper() && remaining[0] != 'P') {
-            pieceType = remaining[0].toLatin1();
-            pos = 1;
-            if (shouldDebug) qDebug() << "  Piece type:" << pieceType;
-        }
-        
-        // Parse disambiguation from remaining characters
-        while (pos < remaining.length()) {
-            QChar c = remaining[pos];
-            if (c >= 'a' && c <= 'h') {
-                fromFile = c.toLatin1() - 'a';
-                if (shouldDebug) qDebug() << "  From file hint:" << fromFile;
-            } else if (c >= '1' && c <= '8') {
-                fromRank = c.toLatin1() - '1';
-                if (shouldDebug) qDebug() << "  From rank hint:" << fromRank;
-            }
-            pos++;
+    int promo = (uci.length() == 5 ? pieceFromLetter(uci[4].toUpper()) : PAWN);
+    if (promo < PAWN || promo == KING) return false;
+
+    Move wanted = encodeMove(squareOf(7 - fromRank, fromCol), squareOf(7 - toRank, toCol), promo);
+    MoveList legalMoves;
+    m_board.generateLegalMoves(legalMoves);
+    for (Move move : legalMoves) {
+        if (move == wanted) {
+            makeMove(move);
+            return true;
         }
     }
-    
-    // Adjust piece type for current player
-    if (!whiteToMove && pieceType != 'P') {
-        pieceType = pieceType + 32; // Convert to lowercase
-    } else if (!whiteToMove && pieceType == 'P') {
-        pieceType = 'p';
-    }
-    
-    if (shouldDebug) {
-        qDebug() << "  Final piece type:" << pieceType << "White to move:" << whiteToMove;
-        qDebug() << "  Disambiguation - fromFile:" << fromFile << "fromRank:" << fromRank;
+    return false;
+}
+
+bool FastChessPosition::makeSanMove(QStringView san)
+{
+    Move move = sanToMove(san);
+    if (move == NULL_MOVE) return false;
+    makeMove(move);
+    return true;
+}
+
+void FastChessPosition::makeMove(Move move)
+{
+    UndoInfo undo;
+    m_board.makeMove(move, undo);
+}
+
+quint64 FastChessPosition::perft(int depth) const
+{
+    MoveList moves;
+    m_board.generateLegalMoves(moves);
+    if (depth <= 1) return depth == 1 ? moves.size() : 1;
+
+    quint64 nodes = 0;
+    for (Move move : moves) {
+        FastChessPosition next = *this;
+        next.makeMove(move);
+        nodes += next.perft(depth - 1);
     }
-    
-    // Find the piece that can make this move
-    if (shouldDebug) {
-        qDebug() << "  Searching for pieces of type:" << pieceType;
-        qDebug() << "  Target square:" << QChar('a' + toFile) << (toRank + 1);
-        qDebug() << "  Piece at target:" << (board[toRank * 8 + toFile] != 0 ? "occupied" : "empty");
-        qDebug() << "  En passant target square:" << (enPassantTarget != -1 ? indexToSquare(enPassantTarget) : "none");
-        
-        if (board[toRank * 8 + toFile] != 0) {
-            qDebug() << "  Target piece:" << board[toRank * 8 + toFile];
+    return nodes;
+}
+
+// Character access shared by the UTF-16 and raw byte versions of replayMainline
+static inline char16_t charAt(QStringView text, qsizetype i) { return text[i].unicode(); }
+static inline char16_t charAt(std::string_view text, size_t i) { return static_cast<unsigned char>(text[i]); }
+
+template <typename Text>
+static int replayMainlineImpl(const BitboardPosition &start, Text bodyText, int maxPlies, QVector<quint64> *hashes,
+                              QVector<Move> *moves, ReplayKey key)
+{
+    FastChessPosition position;
+    position.setBoard(start);
+    auto keyOf = [&position, key]() {
+        const BitboardPosition &board = position.board();
+        return key == ReplayKey::Placement ? board.placementKey(board.sideToMove) : board.key;
+    };
+    if (hashes) hashes->push_back(keyOf());
+
+    // one token buffer per thread, reused across games
+    thread_local std::vector<PGNToken> tokens;
+    tokenizeMovetext(bodyText, tokens);
+
+    int plies = 0, variationDepth = 0;
+    // SAN tokens are short, longer tokens cannot be moves
+    QChar token[16];
+    for (const PGNToken &tkn : tokens) {
+        if (plies >= maxPlies) break;
+
+        // comments, NAGs and variations are skipped entirely
+        if (tkn.type == PGN_VARIATION_START) {
+            ++variationDepth;
+            continue;
         }
-        
-        // Show all pieces of the type we're looking for
-        for (int r = 0; r < 8; r++) {
-            for (int f = 0; f < 8; f++) {
-                if (board[r * 8 + f] == pieceType) {
-                    qDebug() << "    Found" << pieceType << "at" << QChar('a' + f) << (r + 1);
-                }
-            }
+        if (tkn.type == PGN_VARIATION_END) {
+            if (variationDepth > 0) --variationDepth;
+            continue;
         }
-    }
+        if (tkn.type != PGN_WORD || variationDepth) continue;
 
-    int fromIndex = findPieceForMove(pieceType, toFile, toRank, fromFile, fromRank);
-    if (fromIndex == -1) {
-        if (shouldDebug) {
-            qDebug() << "  ERROR: Could not find piece for move";
-            qDebug() << "  Board state (rank 8 to 1):";
-            for (int r = 7; r >= 0; r--) {
-                QString rankStr;
-                for (int f = 0; f < 8; f++) {
-                    char piece = board[r * 8 + f];
-                    rankStr += (piece == 0) ? '.' : piece;
-                }
-                qDebug() << "    Rank" << (r+1) << ":" << rankStr;
-            }
-            qDebug() << "  Looking for piece type:" << pieceType << "to move to" << QChar('a' + toFile) << (toRank + 1);
-            if (fromFile != -1) qDebug() << "  Must be on file:" << QChar('a' + fromFile);
-            if (fromRank != -1) qDebug() << "  Must be on rank:" << (fromRank + 1);
+        // strip move number prefix
+        qint32 start = tkn.offset, end = tkn.offset + tkn.length;
+        qint32 p = start;
+        while (p < end && charAt(bodyText, p) >= '0' && charAt(bodyText, p) <= '9') ++p;
+        if (p > start) {
+            qint32 dotsStart = p;
+            while (p < end && charAt(bodyText, p) == '.') ++p;
+            if (p > dotsStart) start = p;
         }
-        return "";
+        if (start == end) continue;
+
+        int length = end - start;
+        if (length > 16) continue;
+        for (int i = 0; i < length; i++) token[i] = QChar(charAt(bodyText, start + i));
+        QStringView san(token, length);
+
+        // result tokens end the game
+        if (san == QLatin1String("1-0") || san == QLatin1String("0-1") || san == QLatin1String("1/2-1/2") || san == QLatin1String("*")) break;
+
+        Move move = position.sanToMove(san);
+        if (move == NULL_MOVE) continue;
+        position.makeMove(move);
+        ++plies;
+        if (hashes) hashes->push_back(keyOf());
+        if (moves) moves->push_back(move);
     }
-    
-    QString fromSquare = indexToSquare(fromIndex);
-    QString result = fromSquare + destSquare;
-    
-    if (shouldDebug) qDebug() << "  SUCCESS: Converted to UCI:" << result;
-    
-    return result;
+    return plies;
 }
 
-int FastChessPosition::findPieceForMove(char pieceType, int toFile, int toRank, int fromFile, int fromRank)
+static const BitboardPosition &startingPosition()
 {
-    static int debugCount = 0;
-    bool shouldDebug = debugCount < 50;
-    if (shouldDebug) debugCount++;
-    
-    // Simple piece finding - check all squares for the piece type
-    for (int rank = 0; rank < 8; rank++) {
-        for (int file = 0; file < 8; file++) {
-            if (board[rank * 8 + file] == pieceType) {
-                // Check disambiguation
-                if (fromFile != -1 && file != fromFile) continue;
-                if (fromRank != -1 && rank != fromRank) continue;
-                
-                if (shouldDebug) {
-                    qDebug() << "    Checking piece at" << QChar('a' + file) << (rank + 1);
-                }
-                
-                // Basic move validation for piece type
-                bool canMove = false;
-                int deltaFile = toFile - file;
-                int deltaRank = toRank - rank;
-                
-                switch (pieceType) {
-                case 'P': // White pawn
-                    if (deltaFile == 0) { // Forward move
-                        canMove = ((rank == 1 && (toRank == 2 || (toRank == 3 && board[16 + toFile] == 0))) ||
-                                  (rank > 1 && rank < 7 && toRank == rank + 1)) &&
-                                  board[toRank * 8 + toFile] == 0;
-                    } else if (abs(deltaFile) == 1 && deltaRank == 1) { // Diagonal move (capture or en passant)
-                        // Regular capture
-                        if (board[toRank * 8 + toFile] != 0) {
-                            canMove = true;
-                        }
-                        // En passant capture
-                        else if (enPassantTarget == toRank * 8 + toFile) {
-                            canMove = true;
-                        }
-                    }
-                    if (shouldDebug && pieceType == 'P') {
-                        qDebug() << "      White pawn: deltaFile=" << deltaFile << "deltaRank=" << deltaRank;
-                        qDebug() << "      Target occupied:" << (board[toRank * 8 + toFile] != 0);
-                        qDebug() << "      En passant target:" << enPassantTarget << "current target:" << (toRank * 8 + toFile);
-                        qDebug() << "      Can move:" << canMove;
-                    }
-                    break;
-                    
-                case 'p': // Black pawn
-                    if (deltaFile == 0) { // Forward move
-                        canMove = ((rank == 6 && (toRank == 5 || (toRank == 4 && board[40 + toFile] == 0))) ||
-                                  (rank < 6 && rank > 0 && toRank == rank - 1)) &&
-                                  board[toRank * 8 + toFile] == 0;
-                    } else if (abs(deltaFile) == 1 && deltaRank == -1) { // Diagonal move (capture or en passant)
-                        // Regular capture
-                        if (board[toRank * 8 + toFile] != 0) {
-                            canMove = true;
-                        }
-                        // En passant capture
-                        else if (enPassantTarget == toRank * 8 + toFile) {
-                            canMove = true;
-                        }
-                    }
-                    if (shouldDebug && pieceType == 'p') {
-                        qDebug() << "      Black pawn: deltaFile=" << deltaFile << "deltaRank=" << deltaRank;
-                        qDebug() << "      Target occupied:" << (board[toRank * 8 + toFile] != 0);
-                        qDebug() << "      En passant target:" << enPassantTarget << "current target:" << (toRank * 8 + toFile);
-                        qDebug() << "      Can move:" << canMove;
-                    }
-                    break;
-                    
-                case 'R': case 'r': // Rook
-                    canMove = (file == toFile || rank == toRank) && isPathClear(file, rank, toFile, toRank);
-                    break;
-                    
-                case 'N': case 'n': // Knight
-                    canMove = (abs(deltaFile) == 2 && abs(deltaRank) == 1) ||
-                              (abs(deltaFile) == 1 && abs(deltaRank) == 2);
-                    break;
-                    
-                case 'B': case 'b': // Bishop
-                    canMove = abs(deltaFile) == abs(deltaRank) && isPathClear(file, rank, toFile, toRank);
-                    break;
-                    
-                case 'Q': case 'q': // Queen
-                    canMove = ((file == toFile || rank == toRank || abs(deltaFile) == abs(deltaRank)) &&
-                              isPathClear(file, rank, toFile, toRank));
-                    break;
-                    
-                case 'K': case 'k': // King
-                    canMove = abs(deltaFile) <= 1 && abs(deltaRank) <= 1;
-                    break;
-                }
-                
-                if (canMove) {
-                    if (shouldDebug) {
-                        qDebug() << "    Found valid piece at" << QChar('a' + file) << (rank + 1);
-                    }
-                    return rank * 8 + file;
-                }
-            }
-        }
-    }
-    
-    return -1; // Piece not found
+    static const BitboardPosition start = FastChessPosition().board();
+    return start;
 }
 
-// Add this helper method for path checking
-bool FastChessPosition::isPathClear(int fromFile, int fromRank, int toFile, int toRank)
+int replayMainline(QStringView bodyText, int maxPlies, QVector<quint64> *hashes, QVector<Move> *moves, ReplayKey key)
 {
-    int deltaFile = (toFile > fromFile) ? 1 : (toFile < fromFile) ? -1 : 0;
-    int deltaRank = (toRank > fromRank) ? 1 : (toRank < fromRank) ? -1 : 0;
-    
-    int currentFile = fromFile + deltaFile;
-    int currentRank = fromRank + deltaRank;
-    
-    while (currentFile != toFile || currentRank != toRank) {
-        if (board[currentRank * 8 + currentFile] != 0) {
-            return false; // Path is blocked
-        }
-        currentFile += deltaFile;
-        currentRank += deltaRank;
-    }
-    
-    return true;
+    return replayMainlineImpl(startingPosition(), bodyText, maxPlies, hashes, moves, key);
 }
 
-bool FastChessPosition::makeMove(const QString& uci)
+int replayMainline(std::string_view bodyText, int maxPlies, QVector<quint64> *hashes, QVector<Move> *moves, ReplayKey key)
 {
-    if (uci.length() != 4) return false;
-    
-    int fromFile = uci[0].toLatin1() - 'a';
-    int fromRank = uci[1].toLatin1() - '1';
-    int toFile = uci[2].toLatin1() - 'a';
-    int toRank = uci[3].toLatin1() - '1';
-    
-    if (fromFile < 0 || fromFile > 7 || fromRank < 0 || fromRank > 7 ||
-        toFile < 0 || toFile > 7 || toRank < 0 || toRank > 7) {
-        return false;
-    }
-    
-    char piece = pieceAt(fromFile, fromRank);
-    if (piece == 0) return false;
-    
-    // Clear previous en passant target
-    int oldEnPassantTarget = enPassantTarget;
-    enPassantTarget = -1;
-    
-    // Check for en passant capture
-    bool isEnPassant = false;
-    if ((piece == 'P' || piece == 'p') && 
-        abs(toFile - fromFile) == 1 && 
-        board[toRank * 8 + toFile] == 0 &&
-        oldEnPassantTarget == toRank * 8 + toFile) {
-        isEnPassant = true;
-    }
-    
-    // Make the move
-    setPiece(fromFile, fromRank, 0);
-    setPiece(toFile, toRank, piece);
-    
-    // Handle en passant capture - remove the captured pawn
-    if (isEnPassant) {
-        if (piece == 'P') {
-            // White captures black pawn
-            setPiece(toFile, toRank - 1, 0);  // Remove black pawn on rank behind
-        } else {
-            // Black captures white pawn  
-            setPiece(toFile, toRank + 1, 0);  // Remove white pawn on rank behind
-        }
-    }
-    
-    // Set new en passant target for two-square pawn moves
-    if (piece == 'P' && fromRank == 1 && toRank == 3) {
-        // White pawn moved two squares
-        enPassantTarget = 2 * 8 + toFile;  // Target square is on rank 3
-    } else if (piece == 'p' && fromRank == 6 && toRank == 4) {
-        // Black pawn moved two squares
-        enPassantTarget = 5 * 8 + toFile;  // Target square is on rank 6
-    }
-    
-    // Handle castling
-    if ((piece == 'K' || piece == 'k') && abs(toFile - fromFile) == 2) {
-        // Move the rook too
-        if (toFile == 6) { // Kingside
-            char rook = pieceAt(7, fromRank);
-            setPiece(7, fromRank, 0);
-            setPiece(5, fromRank, rook);
-        } else if (toFile == 2) { // Queenside
-            char rook = pieceAt(0, fromRank);
-            setPiece(0, fromRank, 0);
-            setPiece(3, fromRank, rook);
-        }
+    return replayMainlineImpl(startingPosition(), bodyText, maxPlies, hashes, moves, key);
+}
+
+int replayMainline(const BitboardPosition &start, QStringView bodyText, int maxPlies, QVector<quint64> *hashes,
+                   QVector<Move> *moves, ReplayKey key)
+{
+    return replayMainlineImpl(start, bodyText, maxPlies, hashes, moves, key);
+}
+
+int replayMainline(const BitboardPosition &start, std::string_view bodyText, int maxPlies, QVector<quint64> *hashes,
+                   QVector<Move> *moves, ReplayKey key)
+{
+    return replayMainlineImpl(start, bodyText, maxPlies, hashes, moves, key);
+}
+
+bool gameStartPosition(const QVector<QPair<QString, QString>> &headers, BitboardPosition &start)
+{
+    for (const auto &header : headers) {
+        if (header.first != QLatin1String("FEN")) continue;
+        const QByteArray fen = header.second.trimmed().toLatin1();
+        return start.setFen(std::string_view(fen.constData(), static_cast<size_t>(fen.size())));
     }
-    
-    // Update castling rights (simplified)
-    if (piece == 'K') whiteKingside = whiteQueenside = false;
-    if (piece == 'k') blackKingside = blackQueenside = false;
-    if (piece == 'R' && fromFile == 0 && fromRank == 0) whiteQueenside = false;
-    if (piece == 'R' && fromFile == 7 && fromRank == 0) whiteKingside = false;
-    if (piece == 'r' && fromFile == 0 && fromRank == 7) blackQueenside = false;
-    if (piece == 'r' && fromFile == 7 && fromRank == 7) blackKingside = false;
-    
-    whiteToMove = !whiteToMove;
+    start = startingPosition();
     return true;
 }
@@ -2,43 +2,73 @@
 #define FASTCHESSPOSITION_H
 
 #include <QString>
+#include <QStringView>
 #include <QVector>
+#include <QPair>
 
+#include <string_view>
+
+#include "bitboard.h"
+
+// Lightweight position for bulk PGN work: SAN is resolved straight against the legal
+// move generator of the bitboard core, without ChessPosition objects or notation trees
 class FastChessPosition
 {
 public:
     FastChessPosition();
-    
-    // Fast algebraic to UCI conversion without full validation
-    QString algebraicToUCI(const QString& algebraicMove);
-    
-    // Make move and update position (minimal validation)
+
+    // Resolves a SAN move against the legal moves of the current position, NULL_MOVE if none matches
+    Move sanToMove(QStringView san) const;
+
+    // Fast algebraic to UCI conversion, empty if the move is not legal here
+    QString algebraicToUCI(const QString& algebraicMove) const;
+
+    // Make a legal move given in UCI or SAN; the position is left untouched if it is not legal
     bool makeMove(const QString& uci);
-    
+    bool makeSanMove(QStringView san);
+
+    // Make a move produced by sanToMove or the move generator
+    void makeMove(Move move);
+
     // Reset to starting position
     void reset();
+    bool setFen(const QString& fen);
+    void setBoard(const BitboardPosition& board) { m_board = board; }
+
+    // Counts leaf nodes of the legal move tree to the given depth, playing each move on a copy
+    // through makeMove(Move) as the replay does
+    quint64 perft(int depth) const;
+
+    quint64 zobrist() const { return m_board.key; }
+    const BitboardPosition& board() const { return m_board; }
+
+    static QString moveToUCI(Move move);
 
 private:
-    // Simple board representation: piece type at each square
-    // 0=empty, 1=P, 2=N, 3=B, 4=R, 5=Q, 6=K (lowercase for black)
-    char board[64];
-    bool whiteToMove;
-    
-    // Castling rights
-    bool whiteKingside, whiteQueenside, blackKingside, blackQueenside;
-    
-    // En passant target square (-1 if none)
-    int enPassantTarget;
-    
-    // Helper functions
-    int squareToIndex(const QString& square);
-    QString indexToSquare(int index);
-    char pieceAt(int file, int rank);
-    void setPiece(int file, int rank, char piece);
-    bool isPathClear(int fromFile, int fromRank, int toFile, int toRank);
-    
-    // Fast move finding
-    int findPieceForMove(char pieceType, int toFile, int toRank, int fromFile = -1, int fromRank = -1);
+    BitboardPosition m_board;
 };
 
+// Keys replayMainline records: full zobrist keys, or BitboardPosition::placementKey() for
+// searching games by position
+enum class ReplayKey { Zobrist, Placement };
+
+// Replays the mainline of PGN movetext from the starting position, skipping comments, variations,
+// NAGs and move numbers. Undecodable tokens are skipped like the notation parser does.
+// hashes receives the key of the starting position followed by that of the position after each ply.
+// Returns the number of plies played, at most maxPlies.
+int replayMainline(QStringView bodyText, int maxPlies, QVector<quint64> *hashes = nullptr, QVector<Move> *moves = nullptr,
+                   ReplayKey key = ReplayKey::Zobrist);
+// Same over raw PGN bytes, e.g. a span of a mapped file; SAN is ASCII so no decoding is needed
+int replayMainline(std::string_view bodyText, int maxPlies, QVector<quint64> *hashes = nullptr, QVector<Move> *moves = nullptr,
+                   ReplayKey key = ReplayKey::Zobrist);
+// Both replayed from start instead, see gameStartPosition()
+int replayMainline(const BitboardPosition &start, QStringView bodyText, int maxPlies, QVector<quint64> *hashes = nullptr,
+                   QVector<Move> *moves = nullptr, ReplayKey key = ReplayKey::Zobrist);
+int replayMainline(const BitboardPosition &start, std::string_view bodyText, int maxPlies, QVector<quint64> *hashes = nullptr,
+                   QVector<Move> *moves = nullptr, ReplayKey key = ReplayKey::Zobrist);
+
+// Position the mainline of a game with headers starts from: that of its FEN tag, or the starting
+// position when it has none. Returns false when the FEN tag cannot be read
+bool gameStartPosition(const QVector<QPair<QString, QString>> &headers, BitboardPosition &start);
+
 #endif // FASTCHESSPOSITION_H
@@ -19,12 +19,10 @@
 #include <QDateTime>
 
 
-GameplayViewer::GameplayViewer(ChessPosition *positionViewer, QWidget *parent)
+GameplayViewer::GameplayViewer(PositionViewer *positionViewer, QWidget *parent)
     : QWidget(parent)
     , m_positionViewer(positionViewer)
     , m_engine(nullptr)
-    , m_startPosition(new ChessPosition)
-    , m_lastPosition(new ChessPosition)
     , m_root(new QWidget(this))
     , m_controlsWidget(nullptr)
     , m_whiteMs(0)
@@ -34,7 +32,7 @@ GameplayViewer::GameplayViewer(ChessPosition *positionViewer, QWidget *parent)
     , m_active(false)
     , m_engineIdle(true)
 {
-    m_startPosition->copyFrom(*m_positionViewer);
+    m_startPosition = m_positionViewer->position();
 
     QVBoxLayout *rootLay = new QVBoxLayout(this);
     rootLay->setContentsMargins(6,6,6,6);
@@ -533,7 +531,7 @@ void GameplayViewer::onPlayClicked(int selectedSide)
     m_incMs = m_incrementSpin->value() * 1000;
     m_engineDepth = 18 + int(std::round(double(m_eloSlider->value() - 1320) / double(3190 - 1320) * (25 - 18))); // linear depth function [20, 25]
     updateClockDisplays();
-    m_lastPosition->copyFrom(*m_startPosition);
+    m_lastPosition = m_startPosition;
     m_positionViewer->m_premoveEnabled = selectedSide;
     m_engineElo = m_eloSlider->value();
     m_whitePlayerLabel->setText(tr("You"));
@@ -603,18 +601,17 @@ bool GameplayViewer::applyUciMove(const QString &uci)
 {
     if (uci.size() < 4) return false;
     emit selectLastMove();
-    m_positionViewer->copyFrom(*m_lastPosition);
-    int sc = uci[0].toLatin1() - 'a', sr = '8' - uci[1].toLatin1(), dc = uci[2].toLatin1() - 'a', dr = '8' - uci[3].toLatin1();
-    QChar promo = (uci.size() >= 5 ? uci[4].toUpper() : '\0');
-    if (!m_positionViewer->validateMove(sr, sc, dr, dc)) {
-        qDebug() << "Engine played illegal move!" << sr << sc << dr << dc;
+    m_positionViewer->setPosition(m_lastPosition);
+    Move move = uciToMove(uci);
+    if (move == NULL_MOVE || !m_positionViewer->position().isLegalMove(move)) {
+        qDebug() << "Engine played illegal move!" << uci;
         return false;
     }
-    m_positionViewer->buildUserMove(sr, sc, dr, dc, promo);
+    m_positionViewer->buildUserMove(move);
     return true;
 }
 
-void GameplayViewer::onBoardMoveMade(QSharedPointer<NotationMove>& move)
+void GameplayViewer::onBoardMoveMade(NotationMovePtr& move)
 {
     if (!m_active || !m_engineIdle) return;
     if (isPlayersTurn()) { // engine move
@@ -624,7 +621,7 @@ void GameplayViewer::onBoardMoveMade(QSharedPointer<NotationMove>& move)
     m_engineIdle = false;
     turnFinished();
     if (!m_engine) return;
-    m_engine->setPosition(move->m_position->positionToFEN());
+    m_engine->setPosition(move->m_position.positionToFEN());
     if (m_timeCheck->isChecked()) m_engine->goDepthWithClocks(m_engineDepth, m_whiteMs, m_blackMs, m_incMs, m_incMs);
     else m_engine->goDepth(m_engineDepth);
 }
@@ -632,32 +629,32 @@ void GameplayViewer::onBoardMoveMade(QSharedPointer<NotationMove>& move)
 void GameplayViewer::turnFinished(){
     if (!m_active) return;
 
-    m_lastPosition->copyFrom(*m_positionViewer);
+    m_lastPosition = m_positionViewer->position();
     m_positionViewer->updatePremoves(m_premoves);
-    if (m_lastPosition->m_sideToMove != (m_humanSide?'b':'w')){
+    if (m_lastPosition.sideToMove() != (m_humanSide?'b':'w')){
         m_positionViewer->m_premoveEnabled = true;
     }
 
     if (m_moveCount >= 2){
         int elapsedMs = m_clockTimer.elapsed();
-        int& timeMs = (m_lastPosition->m_sideToMove == 'w' ? m_blackMs : m_whiteMs); // sideToMove == 'w' -> black finished turn
+        int& timeMs = (m_lastPosition.sideToMove() == 'w' ? m_blackMs : m_whiteMs); // sideToMove == 'w' -> black finished turn
         timeMs -= (elapsedMs - m_incMs);
     }
     updateClockDisplays();
 
     m_moveCount++;
     updateTakebackEnabled();
-    if (!m_lastPosition->generateLegalMoves().size()){
-        if (m_lastPosition->inCheck(m_lastPosition->m_sideToMove)){
-            finishGame(m_lastPosition->m_sideToMove == 'w' ? "0-1" : "1-0", tr("By checkmate"));
+    if (!m_lastPosition.generateLegalMoves().size()){
+        if (m_lastPosition.inCheck(m_lastPosition.sideToMove())){
+            finishGame(m_lastPosition.sideToMove() == 'w' ? "0-1" : "1-0", tr("By checkmate"));
         } else {
             finishGame("1/2-1/2", tr("By stalement"));
         }
     }
-    if (m_lastPosition->isFiftyMove()){
+    if (m_lastPosition.isFiftyMove()){
         finishGame("1/2-1/2", tr("By 50-move rule"));
     }
-    QString fen = m_lastPosition->positionToFEN(/*forHash=*/true);
+    QString fen = m_lastPosition.positionToFEN(/*forHash=*/true);
     m_positionStack.push(fen);
     m_positionHash[fen]++;
     if (m_positionHash[fen] >= 3){
@@ -667,11 +664,11 @@ void GameplayViewer::turnFinished(){
     scheduleNextDisplayUpdate();
 
     // apply premoves from queue
-    if (m_lastPosition->m_sideToMove == (m_humanSide?'b':'w') && m_premoves.size()){
+    if (m_lastPosition.sideToMove() == (m_humanSide?'b':'w') && m_premoves.size()){
         auto move = m_premoves.takeFirst();
         auto [sr, sc, dr, dc, promo] = move;
-        m_positionViewer->copyFrom(*m_lastPosition);
-        if (!m_lastPosition->validateMove(sr, sc, dr, dc)) { // illegal premove
+        m_positionViewer->setPosition(m_lastPosition);
+        if (!m_lastPosition.validateMove(sr, sc, dr, dc)) { // illegal premove
             m_premoves.clear();
             m_positionViewer->updatePremoves(m_premoves);
         } else {
@@ -683,7 +680,7 @@ void GameplayViewer::turnFinished(){
 void GameplayViewer::scheduleNextDisplayUpdate()
 {
     if (m_updateTimer.isActive()) m_updateTimer.stop();
-    int& timeMs = (m_positionViewer->m_sideToMove == 'w' ? m_whiteMs : m_blackMs);
+    int& timeMs = (m_positionViewer->position().sideToMove() == 'w' ? m_whiteMs : m_blackMs);
     int tenths = (timeMs+99)/100, delay = qMax(1, timeMs-(tenths-1)*100);
     m_updateTimer.start(static_cast<int>(delay));
     m_clockTimer.restart();
@@ -692,12 +689,12 @@ void GameplayViewer::scheduleNextDisplayUpdate()
 void GameplayViewer::onClockTick()
 {
     if (!m_active || !m_timeCheck->isChecked() || m_moveCount < 2) return;
-    int& timeMs = (m_positionViewer->m_sideToMove == 'w' ? m_whiteMs : m_blackMs);
+    int& timeMs = (m_positionViewer->position().sideToMove() == 'w' ? m_whiteMs : m_blackMs);
     timeMs -= m_updateTimer.interval();
     updateClockDisplays();
     scheduleNextDisplayUpdate();
     if (timeMs <= 0) {
-        finishGame(m_positionViewer->m_sideToMove == 'w' ? "0-1" : "1-0", tr("By timeout"));
+        finishGame(m_positionViewer->position().sideToMove() == 'w' ? "0-1" : "1-0", tr("By timeout"));
     }
 }
 
@@ -714,7 +711,7 @@ void GameplayViewer::updateClockDisplays()
     m_blackClock->setText(msToString(isFlipped ? m_whiteMs : m_blackMs));
     m_whitePlayerLabel->setText((isFlipped && !m_humanSide) || (!isFlipped && m_humanSide) ? tr("%1 (%2)").arg(m_engineName).arg(m_engineElo) : tr("You"));
     m_blackPlayerLabel->setText((isFlipped && !m_humanSide) || (!isFlipped && m_humanSide) ? tr("You") : tr("%1 (%2)").arg(m_engineName).arg(m_engineElo));
-    if ((m_positionViewer->m_sideToMove == 'w' && !isFlipped) || (m_positionViewer->m_sideToMove == 'b' && isFlipped)){
+    if ((m_positionViewer->position().sideToMove() == 'w' && !isFlipped) || (m_positionViewer->position().sideToMove() == 'b' && isFlipped)){
         m_whiteClock->setStyleSheet("border: 2px solid green; border-radius: 10px; padding: 6px; background: palette(base);");
         m_blackClock->setStyleSheet("border: 1px solid grey; border-radius: 10px; padding: 6px; background: palette(base);");
     } else {
@@ -839,7 +836,7 @@ void GameplayViewer::finishGame(const QString &result, const QString &descriptio
 
 bool GameplayViewer::isPlayersTurn() const
 {
-    bool whiteToMove = m_positionViewer->m_sideToMove == 'w';
+    bool whiteToMove = m_positionViewer->position().sideToMove() == 'w';
     if (whiteToMove) return (m_humanSide == 0);
     return (m_humanSide == 1);
 }
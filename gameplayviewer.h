@@ -13,18 +13,18 @@
 #include <QStack>
 #include <QElapsedTimer>
 
-#include "chessposition.h"
+#include "positionviewer.h"
 #include "uciengine.h"
 
 class GameplayViewer : public QWidget {
     Q_OBJECT
 public:
-    explicit GameplayViewer(ChessPosition *positionViewer, QWidget *parent = nullptr);
+    explicit GameplayViewer(PositionViewer *positionViewer, QWidget *parent = nullptr);
     bool isEngineIdle(){ return m_engineIdle; };
     QList<SimpleMove> m_premoves;
 
 public slots:
-    void onBoardMoveMade(QSharedPointer<NotationMove>& move);
+    void onBoardMoveMade(NotationMovePtr& move);
     void updateClockDisplays();
 
 signals:
@@ -59,11 +59,11 @@ private:
     bool isPlayersTurn() const;
     void finishGame(const QString &result, const QString &description);
 
-    ChessPosition *m_positionViewer;
+    PositionViewer *m_positionViewer;
     UciEngine *m_engine;
     QMetaObject::Connection m_engineReadyConn;
-    ChessPosition *m_lastPosition;
-    ChessPosition *m_startPosition;
+    ChessPosition m_lastPosition;
+    ChessPosition m_startPosition;
 
     // UI elements (created in-code to avoid extra UI file)
     QWidget *m_root;
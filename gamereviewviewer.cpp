@@ -21,7 +21,7 @@
 #include <QPalette>
 #include <QApplication>
 
-GameReviewViewer::GameReviewViewer(QSharedPointer<NotationMove> rootMove, QWidget *parent)
+GameReviewViewer::GameReviewViewer(NotationMovePtr rootMove, QWidget *parent)
     : QWidget(parent)
     , m_rootMove(rootMove)
 {
@@ -427,7 +427,7 @@ bool GameReviewViewer::eventFilter(QObject *watched, QEvent *event)
         int maxIdx = int(m_moves.size()) - 1;
         int idx = std::clamp(qRound(relX * maxIdx), 0, maxIdx);
 
-        QSharedPointer<NotationMove> selectedMove = m_moves[idx];
+        NotationMovePtr selectedMove = m_moves[idx];
         emit moveSelected(selectedMove);
     }
     return QWidget::eventFilter(watched, event);
@@ -571,18 +571,17 @@ void GameReviewViewer::onBestMove(const QString& bestMove)
     startNextEval();
 }
 
-void GameReviewViewer::reviewGame(const QSharedPointer<NotationMove>& root)
+void GameReviewViewer::reviewGame(const NotationMovePtr& root)
 {
     QVector<QString> fens;
     m_moves.clear();
-    if (!root || !root->m_position) return;
-    fens.append(root->m_position->positionToFEN());
+    if (!root) return;
+    fens.append(root->m_position.positionToFEN());
     m_moves.append(root);
     auto cur = root;
-    while (cur && !cur->m_nextMoves.isEmpty()) {
-        auto nxt = cur->m_nextMoves.front();
-        if (!nxt->m_position) break;
-        fens.append(nxt->m_position->positionToFEN());
+    while (cur && !cur->nextMoves().isEmpty()) {
+        auto nxt = cur->nextMoves().front();
+        fens.append(nxt->m_position.positionToFEN());
         m_moves.append(nxt);
         cur = nxt;
     }
@@ -631,7 +630,7 @@ void GameReviewViewer::finalizeReview()
         double acc = moveAccuracy(wb, wa);
 
         double drop = std::abs(wb - wa);
-        QSharedPointer<NotationMove> move = m_moves[i+1];
+        NotationMovePtr move = m_moves[i+1];
         if (drop >= 0.18) move->annotation1 = "??";
         else if (drop >= 0.12) move->annotation1 = "?";
         else if (drop >= 0.06) move->annotation1 = "?!";
@@ -28,13 +28,13 @@ class GameReviewViewer : public QWidget {
     Q_OBJECT
 
 public:
-    explicit GameReviewViewer(QSharedPointer<NotationMove> rootMove, QWidget *parent = nullptr);
+    explicit GameReviewViewer(NotationMovePtr rootMove, QWidget *parent = nullptr);
 
-    void reviewGame(const QSharedPointer<NotationMove>& root);
+    void reviewGame(const NotationMovePtr& root);
     void autoStartReview();
 
 signals:
-    void moveSelected(QSharedPointer<NotationMove> &move);
+    void moveSelected(NotationMovePtr &move);
     void reviewCompleted();
 
 protected:
@@ -113,8 +113,8 @@ private:
     bool m_isReviewing = false;
     int m_totalEvals = 0;
 
-    QVector<QSharedPointer<NotationMove>> m_moves;
-    QSharedPointer<NotationMove> m_rootMove;
+    QVector<NotationMovePtr> m_moves;
+    NotationMovePtr m_rootMove;
     std::vector<EvalPt> m_origPts;
     std::vector<EvalPt> m_areaPts;
     int m_movetimeMs = 50;
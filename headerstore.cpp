@@ -0,0 +1,249 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "headerstore.h"
+#include "streamparser.h"
+
+#include <QVarLengthArray>
+
+// Tags that are also kept as integers
+enum Typed : quint8 { Plain, TypedWhiteElo, TypedBlackElo, TypedDate, TypedResult };
+
+static quint8 typedField(const QString &tag)
+{
+    if (tag == "WhiteElo") return TypedWhiteElo;
+    if (tag == "BlackElo") return TypedBlackElo;
+    if (tag == "Date") return TypedDate;
+    if (tag == "Result") return TypedResult;
+    return Plain;
+}
+
+// Rating of text, 0 when it is not one or would not be written back the same way
+static quint16 parseElo(const QString &text)
+{
+    bool ok = false;
+    uint elo = text.toUInt(&ok);
+    if (!ok || elo == 0 || elo > 0xFFFF || QString::number(elo) != text) return 0;
+    return static_cast<quint16>(elo);
+}
+
+static QString formatDate(quint32 date)
+{
+    auto part = [](int value, int width) {
+        return value ? QString::number(value).rightJustified(width, '0') : QString(width, '?');
+    };
+    return part(date / 10000, 4) + '.' + part(date / 100 % 100, 2) + '.' + part(date % 100, 2);
+}
+
+// PGN date "yyyy.mm.dd" with "?" for unknown parts, 0 when text is anything else
+static quint32 parseDate(const QString &text)
+{
+    if (text.size() != 10 || text[4] != '.' || text[7] != '.') return 0;
+    auto part = [&text](int from, int width) {
+        int value = 0;
+        for (int i = from; i < from + width; i++) {
+            if (!text[i].isDigit()) return 0;
+            value = value * 10 + text[i].digitValue();
+        }
+        return value;
+    };
+    quint32 date = HeaderStore::packDate(part(0, 4), part(5, 2), part(8, 2));
+    return date && formatDate(date) == text ? date : 0;
+}
+
+static quint8 parseResult(const QString &text)
+{
+    if (text == "1-0") return HeaderStore::WhiteWins;
+    if (text == "0-1") return HeaderStore::BlackWins;
+    if (text == "1/2-1/2") return HeaderStore::Draw;
+    if (text == "*") return HeaderStore::Unfinished;
+    return HeaderStore::NoResult;
+}
+
+QString HeaderStore::resultText(Result result)
+{
+    switch (result) {
+    case HeaderStore::WhiteWins: return QStringLiteral("1-0");
+    case HeaderStore::BlackWins: return QStringLiteral("0-1");
+    case HeaderStore::Draw: return QStringLiteral("1/2-1/2");
+    case HeaderStore::Unfinished: return QStringLiteral("*");
+    default: return QString();
+    }
+}
+
+quint32 HeaderStore::packDate(int year, int month, int day)
+{
+    return static_cast<quint32>(year * 10000 + month * 100 + day);
+}
+
+quint32 HeaderStore::Column::id(qsizetype game) const
+{
+    return static_cast<size_t>(game) < ids.size() ? ids[game] : 0;
+}
+
+void HeaderStore::Column::set(qsizetype game, quint32 id)
+{
+    if (static_cast<size_t>(game) >= ids.size()) {
+        if (!id) return;
+        ids.resize(static_cast<size_t>(game) + 1, 0);
+    }
+    ids[game] = id;
+}
+
+quint32 HeaderStore::Column::intern(const QString &value)
+{
+    auto it = idOfValue.constFind(value);
+    if (it != idOfValue.constEnd()) return it.value();
+    dictionary << value;
+    quint32 id = static_cast<quint32>(dictionary.size());
+    idOfValue.insert(value, id);
+    return id;
+}
+
+void HeaderStore::clear()
+{
+    m_columns.clear();
+    m_columnOfTag.clear();
+    m_whiteElo.clear();
+    m_blackElo.clear();
+    m_dates.clear();
+    m_results.clear();
+    m_plyCounts.clear();
+}
+
+void HeaderStore::reserve(qsizetype games)
+{
+    const size_t count = static_cast<size_t>(games);
+    m_whiteElo.reserve(count);
+    m_blackElo.reserve(count);
+    m_dates.reserve(count);
+    m_results.reserve(count);
+    m_plyCounts.reserve(count);
+}
+
+int HeaderStore::columnFor(const QString &tag)
+{
+    auto it = m_columnOfTag.constFind(tag);
+    if (it != m_columnOfTag.constEnd()) return it.value();
+    Column column;
+    column.tag = tag;
+    column.typed = typedField(tag);
+    m_columns.push_back(std::move(column));
+    int index = static_cast<int>(m_columns.size()) - 1;
+    m_columnOfTag.insert(tag, index);
+    return index;
+}
+
+void HeaderStore::write(qsizetype game, const QVector<QPair<QString,QString>> &headers, TagColumns *resolved)
+{
+    // a tag given twice keeps its first value, as it is shown in the table
+    QVarLengthArray<int, 16> written;
+    for (qsizetype i = 0; i < headers.size(); i++) {
+        const auto &[tag, text] = headers[i];
+        int index;
+        if (!resolved) {
+            index = columnFor(tag);
+        } else if (i < resolved->size() && (*resolved)[i].first == tag) {
+            index = (*resolved)[i].second;
+        } else {
+            index = columnFor(tag);
+            if (i < resolved->size()) (*resolved)[i] = {tag, index};
+            else resolved->push_back({tag, index});
+        }
+        if (written.contains(index)) continue;
+        written.append(index);
+
+        Column &column = m_columns[index];
+        switch (column.typed) {
+        case TypedWhiteElo:
+            if ((m_whiteElo[game] = parseElo(text))) continue;
+            break;
+        case TypedBlackElo:
+            if ((m_blackElo[game] = parseElo(text))) continue;
+            break;
+        case TypedDate:
+            if ((m_dates[game] = parseDate(text))) continue;
+            break;
+        case TypedResult:
+            if ((m_results[game] = parseResult(text))) continue;
+            break;
+        }
+        column.set(game, column.intern(text));
+    }
+}
+
+void HeaderStore::appendRow(int plyCount)
+{
+    m_whiteElo.push_back(0);
+    m_blackElo.push_back(0);
+    m_dates.push_back(0);
+    m_results.push_back(NoResult);
+    m_plyCounts.push_back(plyCount);
+}
+
+void HeaderStore::append(const QVector<QPair<QString,QString>> &headers, int plyCount)
+{
+    appendRow(plyCount);
+    write(size() - 1, headers);
+}
+
+void HeaderStore::append(const std::vector<PGNGameRecord> &records, qsizetype begin, qsizetype end)
+{
+    TagColumns resolved;
+    for (qsizetype i = begin; i < end; i++) {
+        appendRow(records[i].plyCount);
+        write(size() - 1, records[i].headerInfo, &resolved);
+    }
+}
+
+void HeaderStore::replace(qsizetype game, const QVector<QPair<QString,QString>> &headers)
+{
+    m_whiteElo[game] = 0;
+    m_blackElo[game] = 0;
+    m_dates[game] = 0;
+    m_results[game] = NoResult;
+    for (Column &column : m_columns) {
+        column.set(game, 0);
+    }
+    write(game, headers);
+}
+
+void HeaderStore::remove(qsizetype game)
+{
+    m_whiteElo.erase(m_whiteElo.begin() + game);
+    m_blackElo.erase(m_blackElo.begin() + game);
+    m_dates.erase(m_dates.begin() + game);
+    m_results.erase(m_results.begin() + game);
+    m_plyCounts.erase(m_plyCounts.begin() + game);
+    for (Column &column : m_columns) {
+        if (static_cast<size_t>(game) < column.ids.size()) column.ids.erase(column.ids.begin() + game);
+    }
+}
+
+QString HeaderStore::value(qsizetype game, int column) const
+{
+    const Column &c = m_columns[column];
+    if (quint32 id = c.id(game)) return c.dictionary[id - 1];
+
+    switch (c.typed) {
+    case TypedWhiteElo:
+        if (m_whiteElo[game]) return QString::number(m_whiteElo[game]);
+        break;
+    case TypedBlackElo:
+        if (m_blackElo[game]) return QString::number(m_blackElo[game]);
+        break;
+    case TypedDate:
+        if (m_dates[game]) return formatDate(m_dates[game]);
+        break;
+    case TypedResult:
+        return resultText(static_cast<Result>(m_results[game]));
+    }
+    return QString();
+}
+
+QString HeaderStore::value(qsizetype game, const QString &tag) const
+{
+    int index = column(tag);
+    return index < 0 ? QString() : value(game, index);
+}
@@ -0,0 +1,98 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef HEADERSTORE_H
+#define HEADERSTORE_H
+
+#include <QHash>
+#include <QPair>
+#include <QSharedData>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <vector>
+
+struct PGNGameRecord;
+
+// Header tags of every game in a database, stored by column instead of by game. Each tag has a
+// column of ids into its own dictionary, so a player or event name is kept once however many games
+// it appears in. Elo, Date and Result are also kept as integers for filtering and sorting; their
+// text column only holds the values that the integer does not reproduce (e.g. "?" or "2023.??.xx").
+// It is implicitly shared, so a filter run can read it while the table detaches a copy to change
+class HeaderStore : public QSharedData
+{
+public:
+    enum Result : quint8 { NoResult, WhiteWins, BlackWins, Draw, Unfinished };
+
+    qsizetype size() const { return static_cast<qsizetype>(m_plyCounts.size()); }
+    void clear();
+    void reserve(qsizetype games);
+
+    // Adds a game, plyCount is its mainline length or -1 when unknown
+    void append(const QVector<QPair<QString,QString>> &headers, int plyCount);
+    // Adds records[begin, end) in order. Games of a PGN list their tags in the same order, so the
+    // column of each tag is looked up once and reused while the next game has the same tag there
+    void append(const std::vector<PGNGameRecord> &records, qsizetype begin, qsizetype end);
+    // Replaces the tags of a game, its ply count is kept
+    void replace(qsizetype game, const QVector<QPair<QString,QString>> &headers);
+    void remove(qsizetype game);
+
+    // Column of tag, -1 when no game has had it
+    int column(const QString &tag) const { return m_columnOfTag.value(tag, -1); }
+    // Tag text of a game as written in the PGN, "" when the game does not have it
+    QString value(qsizetype game, int column) const;
+    QString value(qsizetype game, const QString &tag) const;
+    // Equal ids in a column are equal texts; 0 when the text is missing or held as an integer
+    quint32 valueId(qsizetype game, int column) const { return m_columns[column].id(game); }
+    // Texts of the ids of a column, id i is dictionary(column)[i - 1]
+    const QStringList &dictionary(int column) const { return m_columns[column].dictionary; }
+    // True when every value of the column is in its dictionary, i.e. it is not an integer tag
+    bool isTextOnly(int column) const { return m_columns[column].typed == 0; }
+    int columnCount() const { return static_cast<int>(m_columns.size()); }
+
+    // 0 when missing or not a rating
+    int whiteElo(qsizetype game) const { return m_whiteElo[game]; }
+    int blackElo(qsizetype game) const { return m_blackElo[game]; }
+    // yyyymmdd with unknown parts as 0, e.g. 20230500 for "2023.05.??"; 0 when missing
+    quint32 date(qsizetype game) const { return m_dates[game]; }
+    Result result(qsizetype game) const { return static_cast<Result>(m_results[game]); }
+    int plyCount(qsizetype game) const { return m_plyCounts[game]; }
+
+    static quint32 packDate(int year, int month, int day);
+    // Text of a result as written in the PGN, "" for NoResult
+    static QString resultText(Result result);
+
+private:
+    struct Column {
+        QString tag;
+        quint8 typed = 0; // which integer column also holds the tag, if any
+        // ids of the games up to the last one that has a value, id 0 is no value
+        std::vector<quint32> ids;
+        QStringList dictionary;
+        QHash<QString, quint32> idOfValue;
+
+        quint32 id(qsizetype game) const;
+        void set(qsizetype game, quint32 id);
+        quint32 intern(const QString &value);
+    };
+
+    // Column of the tag at each position of the previous game
+    typedef QVector<QPair<QString,int>> TagColumns;
+
+    void write(qsizetype game, const QVector<QPair<QString,QString>> &headers, TagColumns *resolved = nullptr);
+    void appendRow(int plyCount);
+    int columnFor(const QString &tag);
+
+    std::vector<Column> m_columns;
+    QHash<QString, int> m_columnOfTag;
+
+    std::vector<quint16> m_whiteElo;
+    std::vector<quint16> m_blackElo;
+    std::vector<quint32> m_dates;
+    std::vector<quint8> m_results;
+    std::vector<qint32> m_plyCounts;
+};
+
+#endif // HEADERSTORE_H
@@ -20,9 +20,28 @@ Jan 15, 2025 - Program Creation
 #include "theme.h"
 #include "helpers.h"
 #include "chessposition.h"
+#include "perft.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <cstdio>
+#endif
 
 int main(int argc, char *argv[])
 {
+    // headless move generator check and benchmark: ChessMD --perft
+    if (argc > 1 && QString(argv[1]) == "--perft") {
+#ifdef Q_OS_WIN
+        // the app is built for the GUI subsystem, so the report goes to the console it was started from
+        if (AttachConsole(ATTACH_PARENT_PROCESS)) freopen("CONOUT$", "w", stdout);
+#endif
+        initZobristTables();
+        initAttackTables();
+        int failures = runPerftSuite();
+        failures += runNotationChecks();
+        return failures ? 1 : 0;
+    }
+
     QSettings settings;
     QString theme = settings.value("theme", "light").toString();
 
@@ -46,6 +65,7 @@ int main(int argc, char *argv[])
     app.setWindowIcon(QIcon(":/resource/img/logo.png"));
 
     initZobristTables();
+    initAttackTables();
     qRegisterMetaType<SimpleMove>("SimpleMove");
 
     // render the main window
@@ -4,7 +4,7 @@ March 18, 2025: File Creation
 
 
 #include "notation.h"
-#include "chessposition.h"
+#include "compactgame.h"
 
 #include <QDebug>
 
@@ -28,31 +28,85 @@ const QVector<CommentEntry> COMMENT_ENTRIES = {
     { QObject::tr("Enter Comment After"), &NotationMove::commentAfter }
 };
 
-NotationMove::NotationMove(const QString &text, ChessPosition &position)
+NotationMove::NotationMove(NotationArena *arena, const QString &text, const ChessPosition &position)
+    : m_position(position)
+    , m_arena(arena)
 {
     moveText = text;
-    QSharedPointer<ChessPosition> pos = QSharedPointer<ChessPosition>::create();
-    pos->copyFrom(position);
-    m_position = pos;
 }
 
-QSharedPointer<NotationMove> cloneNotationTree(QSharedPointer<NotationMove>& move)
+NotationMovePtr NotationMove::create(const QString &text, const ChessPosition &position)
 {
-    if (!move) return nullptr;
+    return (new NotationArena)->createMove(text, position);
+}
 
-    ChessPosition newPos;
-    newPos.copyFrom(*move->m_position);
-    auto copy = QSharedPointer<NotationMove>::create(move->moveText, newPos);
+NotationArena::~NotationArena() = default;
+
+NotationMove *NotationArena::createMove(const QString &text, const ChessPosition &position)
+{
+    return m_moves.create(this, text, position);
+}
+
+QList<NotationMove*>& NotationMove::nextMoves()
+{
+    if (m_lazyGame) createLazyMoves();
+    return m_nextMoves;
+}
+
+void NotationMove::clearNextMoves()
+{
+    m_lazyGame.reset();
+    m_nextMoves.clear();
+}
+
+void NotationMove::loadCompactNode(const QSharedPointer<const CompactGame> &game, qint32 node)
+{
+    if (const CompactAnnotation *annotation = game->annotation(node)) {
+        commentAfter = annotation->commentAfter;
+        annotation1 = annotation->annotation1;
+    }
+    m_lazyGame = game->children(node).isEmpty() ? nullptr : game;
+    m_lazyNode = node;
+}
+
+void NotationMove::createLazyMoves()
+{
+    QSharedPointer<const CompactGame> game;
+    game.swap(m_lazyGame);
+
+    const QVector<qint32> children = game->children(m_lazyNode);
+    for (qint32 node : children) {
+        Move move = game->move(node);
+        NotationMove *child = m_arena->createMove(m_position.lanToSan(move), m_position);
+        child->m_position.applyMove(move);
+        // the compact game keeps only the move, check and mate marks are found again
+        child->moveText += child->m_position.checkSuffix();
+        child->m_move = move;
+        child->m_zobristHash = child->m_position.computeZobrist();
+        child->loadCompactNode(game, node);
+        // same tree, linked directly
+        child->isVarRoot = !m_nextMoves.isEmpty();
+        child->m_previousMove = this;
+        m_nextMoves.append(child);
+    }
+}
+
+NotationMove *cloneNotationTree(NotationArena *arena, NotationMove *move)
+{
+    NotationMove *copy = arena->createMove(move->moveText, move->m_position);
     copy->FEN = move->FEN;
     copy->m_zobristHash = move->m_zobristHash;
-    copy->lanText = move->lanText;
+    copy->m_move = move->m_move;
     copy->commentBefore = move->commentBefore;
     copy->annotation1 = move->annotation1;
     copy->annotation2 = move->annotation2;
     copy->commentAfter = move->commentAfter;
     copy->isVarRoot = move->isVarRoot;
-    for (auto& childMove : move->m_nextMoves) {
-        auto childCopy = cloneNotationTree(childMove);
+    // moves that were never created stay that way in the copy
+    copy->m_lazyGame = move->m_lazyGame;
+    copy->m_lazyNode = move->m_lazyNode;
+    for (NotationMove *childMove : std::as_const(move->m_nextMoves)) {
+        NotationMove *childCopy = cloneNotationTree(arena, childMove);
         childCopy->m_previousMove = copy;
         copy->m_nextMoves.append(childCopy);
     }
@@ -60,72 +114,83 @@ QSharedPointer<NotationMove> cloneNotationTree(QSharedPointer<NotationMove>& mov
     return copy;
 }
 
+NotationMovePtr cloneNotationTree(NotationMovePtr& move)
+{
+    if (!move) return nullptr;
+    return cloneNotationTree(new NotationArena, move.data());
+}
+
 // Returns the child if not found in parent next moves, otherwise return existing move
-QSharedPointer<NotationMove> getUniqueNextMove(const QSharedPointer<NotationMove>& parent, const QSharedPointer<NotationMove> child)
+NotationMovePtr getUniqueNextMove(const NotationMovePtr& parent, const NotationMovePtr child)
 {
-    if (!child->m_zobristHash) child->m_zobristHash = child->m_position->computeZobrist();
-    for (const auto& move: std::as_const(parent->m_nextMoves)){
-        if (!move->m_zobristHash) move->m_zobristHash = move->m_position->computeZobrist();
+    if (!child->m_zobristHash) child->m_zobristHash = child->m_position.computeZobrist();
+    for (const auto& move: std::as_const(parent->nextMoves())){
+        if (!move->m_zobristHash) move->m_zobristHash = move->m_position.computeZobrist();
         if (move->m_zobristHash == child->m_zobristHash) return move;
     }
     return child;
 }
 
 // Links a new move to a previous move in the game tree
-void linkMoves(const QSharedPointer<NotationMove>& parent, const QSharedPointer<NotationMove>& child)
+NotationMovePtr linkMoves(const NotationMovePtr& parent, const NotationMovePtr& child)
 {
-    if (parent == child) return;
-    if (parent->m_nextMoves.size()){
-        child->isVarRoot = true;
+    if (parent == child) return child;
+    // moves of another tree are copied in, the trees are freed independently
+    NotationMove *linked = (child->arena() == parent->arena() ? child.data() : cloneNotationTree(parent->arena(), child.data()));
+    if (parent->nextMoves().size()){
+        linked->isVarRoot = true;
     }
-    parent->m_nextMoves.append(child);
-    child->m_previousMove = parent;
+    parent->nextMoves().append(linked);
+    linked->m_previousMove = parent;
+    return linked;
 }
 
 // Deletes the current selected move
-QSharedPointer<NotationMove> deleteMove(const QSharedPointer<NotationMove>& move)
+NotationMovePtr deleteMove(const NotationMovePtr& move)
 {
     if (!move->m_previousMove) return move;
-    for (int i = 0; i < move->m_previousMove.toStrongRef()->m_nextMoves.size(); i++){
-        if (move->m_previousMove.toStrongRef()->m_nextMoves[i]->moveText == move->moveText){
-            move->m_previousMove.toStrongRef()->m_nextMoves.erase(move->m_previousMove.toStrongRef()->m_nextMoves.begin()+i);
+    for (int i = 0; i < move->m_previousMove->nextMoves().size(); i++){
+        if (move->m_previousMove->nextMoves()[i]->moveText == move->moveText){
+            move->m_previousMove->nextMoves().erase(move->m_previousMove->nextMoves().begin()+i);
             break;
         }
     }
     return move->m_previousMove;
 }
 
-void deleteSubtree(QSharedPointer<NotationMove>& move){
+void deleteSubtree(NotationMovePtr& move){
     if (!move) return;
-    for (auto& childMove: move->m_nextMoves){
-        deleteSubtree(childMove);
-        childMove.reset();
+    // moves that were never created have nothing to delete, the memory goes with the arena
+    for (NotationMove *childMove: std::as_const(move->m_nextMoves)){
+        NotationMovePtr child = childMove;
+        deleteSubtree(child);
     }
-    move->m_nextMoves.clear();
+    move->clearNextMoves();
 }
 
-void deleteAllCommentary(QSharedPointer<NotationMove>& move){
+void deleteAllCommentary(NotationMovePtr& move){
     move->annotation1.clear();
     move->annotation2.clear();
     move->commentAfter.clear();
     move->commentBefore.clear();
-    for (auto& childMove : move->m_nextMoves) {
-        deleteAllCommentary(childMove);
+    for (NotationMove *childMove : move->nextMoves()) {
+        NotationMovePtr child = childMove;
+        deleteAllCommentary(child);
     }
 }
 
 // Deletes the entire variation of the current selected move
-QSharedPointer<NotationMove> deleteVariation(const QSharedPointer<NotationMove>& move)
+NotationMovePtr deleteVariation(const NotationMovePtr& move)
 {
-    QSharedPointer<NotationMove> temp = move;
+    NotationMovePtr temp = move;
     while(temp->m_previousMove != nullptr && !temp->isVarRoot){
         temp = temp->m_previousMove;
     }
     if (temp->m_previousMove != nullptr){
         // Find the required variation and remove it
-        for (int i = 0; i < temp->m_previousMove.toStrongRef()->m_nextMoves.size(); i++){
-            if (temp->m_previousMove.toStrongRef()->m_nextMoves[i]->moveText == temp->moveText){
-                temp->m_previousMove.toStrongRef()->m_nextMoves.erase(temp->m_previousMove.toStrongRef()->m_nextMoves.begin()+i);
+        for (int i = 0; i < temp->m_previousMove->nextMoves().size(); i++){
+            if (temp->m_previousMove->nextMoves()[i]->moveText == temp->moveText){
+                temp->m_previousMove->nextMoves().erase(temp->m_previousMove->nextMoves().begin()+i);
                 break;
             }
         }
@@ -135,19 +200,19 @@ QSharedPointer<NotationMove> deleteVariation(const QSharedPointer<NotationMove>&
     }
 }
 
-void promoteVariation(const QSharedPointer<NotationMove>& move)
+void promoteVariation(const NotationMovePtr& move)
 {
-    QSharedPointer<NotationMove> temp = move;
+    NotationMovePtr temp = move;
     while(temp->m_previousMove != nullptr && !temp->isVarRoot){
         temp = temp->m_previousMove;
     }
     temp->isVarRoot = false;
     if (temp->m_previousMove != nullptr){
         // Find the required variation and remove it
-        for (int i = 0; i < temp->m_previousMove.toStrongRef()->m_nextMoves.size(); i++){
-            if (temp->m_previousMove.toStrongRef()->m_nextMoves[i]->moveText == temp->moveText){
-                temp->m_previousMove.toStrongRef()->m_nextMoves[0]->isVarRoot = true;
-                swap(temp->m_previousMove.toStrongRef()->m_nextMoves[0], temp->m_previousMove.toStrongRef()->m_nextMoves[i]);
+        for (int i = 0; i < temp->m_previousMove->nextMoves().size(); i++){
+            if (temp->m_previousMove->nextMoves()[i]->moveText == temp->moveText){
+                temp->m_previousMove->nextMoves()[0]->isVarRoot = true;
+                std::swap(temp->m_previousMove->nextMoves()[0], temp->m_previousMove->nextMoves()[i]);
                 break;
             }
         }
@@ -9,35 +9,130 @@ March 18, 2025: File Creation
 #include <QObject>
 #include <QList>
 #include <QSharedPointer>
+#include <QAtomicInt>
 #include <QMap>
 #include <QKeySequence>
 #include <QtGlobal>
 
-class ChessPosition;
+#include "arena.h"
+#include "bitboard.h"
+#include "chessposition.h"
+
+class CompactGame;
+class NotationArena;
+class NotationMove;
+
+// Handle to a move of a game tree. The moves of a tree live in one NotationArena and a handle
+// counts references to the whole arena, so links inside the tree are plain pointers and the
+// tree is freed in one go when the last handle into it goes away
+class NotationMovePtr
+{
+public:
+    NotationMovePtr() = default;
+    NotationMovePtr(std::nullptr_t) {}
+    NotationMovePtr(NotationMove *move);
+    NotationMovePtr(const NotationMovePtr &other) : NotationMovePtr(other.m_move) {}
+    NotationMovePtr(NotationMovePtr &&other) noexcept : m_move(other.m_move) { other.m_move = nullptr; }
+    ~NotationMovePtr();
+
+    NotationMovePtr &operator=(NotationMovePtr other) noexcept
+    {
+        std::swap(m_move, other.m_move);
+        return *this;
+    }
+
+    NotationMove *data() const { return m_move; }
+    NotationMove *operator->() const { return m_move; }
+    NotationMove &operator*() const { return *m_move; }
+    operator NotationMove*() const { return m_move; }
+    bool isNull() const { return !m_move; }
+    void reset() { *this = nullptr; }
+
+private:
+    NotationMove *m_move = nullptr;
+};
 
 // Individual node inside the chess game tree, containing information of the position that is reached after playing a move
 class NotationMove
 {
 public:
-    NotationMove(const QString &text, ChessPosition &position);
+    // A move in a tree of its own
+    static NotationMovePtr create(const QString &text, const ChessPosition &position);
+
+    NotationMove(NotationArena *arena, const QString &text, const ChessPosition &position);
+    NotationMove(const NotationMove &) = delete;
+    NotationMove &operator=(const NotationMove &) = delete;
+
+    // The arena of the tree this move belongs to, moves created there can be linked below this one
+    NotationArena *arena() const { return m_arena; }
+
+    // Next moves, main line first. Moves of a parsed game are created here the first time they are asked for
+    QList<NotationMove*>& nextMoves();
+    // Removes all next moves, including ones that were never created
+    void clearNextMoves();
+    // Takes the commentary of node and creates the next moves from its children on demand
+    void loadCompactNode(const QSharedPointer<const CompactGame> &game, qint32 node);
 
     QString FEN;
     quint64 m_zobristHash = 0;
 
     QString commentBefore;
     QString moveText;
-    QString lanText;
     QString annotation1;
     QString annotation2;
     QString commentAfter;
 
     bool isVarRoot = false;
+    Move m_move = NULL_MOVE;
+
+    ChessPosition m_position;
+    NotationMove *m_previousMove = nullptr;
 
-    QSharedPointer<ChessPosition> m_position;
-    QList<QSharedPointer<NotationMove>> m_nextMoves;
-    QWeakPointer<NotationMove> m_previousMove;
+private:
+    friend NotationMove *cloneNotationTree(NotationArena *arena, NotationMove *move);
+    friend void deleteSubtree(NotationMovePtr& move);
+    void createLazyMoves();
+
+    NotationArena *m_arena;
+    QList<NotationMove*> m_nextMoves;
+    // Set while the next moves still only exist in a compact game
+    QSharedPointer<const CompactGame> m_lazyGame;
+    qint32 m_lazyNode = 0;
+};
+
+// Owns every move of one game tree. Handles keep it alive, see NotationMovePtr
+class NotationArena
+{
+public:
+    NotationArena() = default;
+    NotationArena(const NotationArena &) = delete;
+    NotationArena &operator=(const NotationArena &) = delete;
+    ~NotationArena();
+
+    // A move of this tree that is not linked anywhere yet
+    NotationMove *createMove(const QString &text, const ChessPosition &position);
+
+    void ref() { m_refs.ref(); }
+    void deref()
+    {
+        if (!m_refs.deref()) delete this;
+    }
+
+private:
+    QAtomicInt m_refs = 0;
+    ArenaPool<NotationMove> m_moves;
 };
 
+inline NotationMovePtr::NotationMovePtr(NotationMove *move) : m_move(move)
+{
+    if (m_move) m_move->arena()->ref();
+}
+
+inline NotationMovePtr::~NotationMovePtr()
+{
+    if (m_move) m_move->arena()->deref();
+}
+
 struct AnnotationOption {
     QString text;
     bool secondary;
@@ -53,14 +148,17 @@ extern const QMap<int, QString> NUMERIC_ANNOTATION_MAP;
 extern const QVector<AnnotationOption> ANNOTATION_OPTIONS ;
 extern const QVector<CommentEntry> COMMENT_ENTRIES;
 
-QSharedPointer<NotationMove> cloneNotationTree(QSharedPointer<NotationMove>& move);
+NotationMovePtr cloneNotationTree(NotationMovePtr& move);
+// Copies the subtree of move into arena and returns the copy of move
+NotationMove *cloneNotationTree(NotationArena *arena, NotationMove *move);
 
-QSharedPointer<NotationMove> getUniqueNextMove(const QSharedPointer<NotationMove>& parent, const QSharedPointer<NotationMove> child);
-void linkMoves(const QSharedPointer<NotationMove>& parent, const QSharedPointer<NotationMove>& child);
-QSharedPointer<NotationMove> deleteMove(const QSharedPointer<NotationMove>& move);
-void deleteSubtree(QSharedPointer<NotationMove>& move);
-void deleteAllCommentary(QSharedPointer<NotationMove>& move);
-void promoteVariation(const QSharedPointer<NotationMove>& move);
-QSharedPointer<NotationMove> deleteVariation(const QSharedPointer<NotationMove>& move);
+NotationMovePtr getUniqueNextMove(const NotationMovePtr& parent, const NotationMovePtr child);
+// Returns the linked move, a copy of child when it belongs to another tree
+NotationMovePtr linkMoves(const NotationMovePtr& parent, const NotationMovePtr& child);
+NotationMovePtr deleteMove(const NotationMovePtr& move);
+void deleteSubtree(NotationMovePtr& move);
+void deleteAllCommentary(NotationMovePtr& move);
+void promoteVariation(const NotationMovePtr& move);
+NotationMovePtr deleteVariation(const NotationMovePtr& move);
 
 #endif // NOTATION_H
@@ -35,7 +35,7 @@ NotationViewer::NotationViewer(PGNGame game, QWidget* parent)
     setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
 }
 
-void NotationViewer::setRootMove(const QSharedPointer<NotationMove>& notation)
+void NotationViewer::setRootMove(const NotationMovePtr& notation)
 {
     m_rootMove = notation;
     m_selectedMove = m_rootMove;
@@ -45,12 +45,12 @@ void NotationViewer::setRootMove(const QSharedPointer<NotationMove>& notation)
     viewport()->update();
 }
 
-QSharedPointer<NotationMove> NotationViewer::getRootMove()
+NotationMovePtr NotationViewer::getRootMove()
 {
     return m_rootMove;
 }
 
-QSharedPointer<NotationMove> NotationViewer::getSelectedMove()
+NotationMovePtr NotationViewer::getSelectedMove()
 {
     return m_selectedMove;
 }
@@ -127,7 +127,7 @@ void drawManuallyWrappedText(QPainter &painter, const QString &text, int indent,
 }
 
 
-void NotationViewer::drawMove(QPainter &painter, const QSharedPointer<NotationMove>& currentMove, int indent, int& x, int& y, bool isMain)
+void NotationViewer::drawMove(QPainter &painter, const NotationMovePtr& currentMove, int indent, int& x, int& y, bool isMain)
 {
     QFont normal = painter.font();
     QFontMetrics fm(normal);
@@ -140,8 +140,8 @@ void NotationViewer::drawMove(QPainter &painter, const QSharedPointer<NotationMo
     }
 
     QString numPrefix;
-    int moveNum = currentMove->m_position->getPlyCount()/2 + 1;
-    if (currentMove->m_position->m_sideToMove == 'b') {
+    int moveNum = currentMove->m_position.getPlyCount()/2 + 1;
+    if (currentMove->m_position.sideToMove() == 'b') {
         numPrefix = QString::number(moveNum) + ".";
     } else if (currentMove->isVarRoot) {
         numPrefix = QString::number(moveNum) + "...";
@@ -184,7 +184,7 @@ void NotationViewer::drawMove(QPainter &painter, const QSharedPointer<NotationMo
     }
 }
 
-void NotationViewer::drawNotation(QPainter &painter, const QSharedPointer<NotationMove>& currentMove, int indent, int& x, int& y, bool isMain, bool shouldDrawMove)
+void NotationViewer::drawNotation(QPainter &painter, const NotationMovePtr& currentMove, int indent, int& x, int& y, bool isMain, bool shouldDrawMove)
 {
     QFontMetrics fm(painter.font());
     int lineHeight = fm.height() + m_lineSpacing;
@@ -200,23 +200,23 @@ void NotationViewer::drawNotation(QPainter &painter, const QSharedPointer<Notati
         drawMove(painter, currentMove, indent, x, y, isMain);
     }
 
-    if (currentMove->m_nextMoves.size() == 1){
+    if (currentMove->nextMoves().size() == 1){
         // Continue down current variation
-        drawNotation(painter, currentMove->m_nextMoves.front(), indent, x, y, isMain);
-    } else if (currentMove->m_nextMoves.size() > 1){
-        drawMove(painter, currentMove->m_nextMoves.front(), indent, x, y, isMain);
+        drawNotation(painter, currentMove->nextMoves().front(), indent, x, y, isMain);
+    } else if (currentMove->nextMoves().size() > 1){
+        drawMove(painter, currentMove->nextMoves().front(), indent, x, y, isMain);
         // Go through variations
         y += lineHeight;
-        for (int i = 1; i < currentMove->m_nextMoves.size(); i++) {
+        for (int i = 1; i < currentMove->nextMoves().size(); i++) {
             // Use DFS search to explore all moves in the game tree
             x = indent + m_indentStep;
-            drawNotation(painter, currentMove->m_nextMoves[i], indent + m_indentStep, x, y, false);
+            drawNotation(painter, currentMove->nextMoves()[i], indent + m_indentStep, x, y, false);
             x = indent;
         }
-        drawNotation(painter, currentMove->m_nextMoves.front(), indent, x, y, isMain, false);
+        drawNotation(painter, currentMove->nextMoves().front(), indent, x, y, isMain, false);
     }
 
-    if (indent && !currentMove->m_nextMoves.size()) {
+    if (indent && !currentMove->nextMoves().size()) {
         // Variation ended, draw the closing bracket and add a new line.
         painter.drawText(x, y + fm.ascent(), ")");
         x += fm.horizontalAdvance(")");
@@ -272,9 +272,9 @@ void NotationViewer::selectPreviousMove()
 
 void NotationViewer::selectNextMove()
 {
-    if (m_selectedMove != nullptr && !m_selectedMove->m_nextMoves.isEmpty()){
-        if (m_selectedMove->m_nextMoves.size() == 1){
-            m_selectedMove = m_selectedMove->m_nextMoves.front();
+    if (m_selectedMove != nullptr && !m_selectedMove->nextMoves().isEmpty()){
+        if (m_selectedMove->nextMoves().size() == 1){
+            m_selectedMove = m_selectedMove->nextMoves().front();
         } else {
             VariationDialogue dialog(this);
             dialog.setVariations(m_selectedMove);
@@ -302,15 +302,21 @@ void NotationViewer::refresh(bool refreshLayout)
     viewport()->update();
 }
 
-void NotationViewer::onEngineMoveClicked(QSharedPointer<NotationMove> &move) {
+void NotationViewer::onEngineMoveClicked(NotationMovePtr &move) {
     m_isEdited = true;
-    QSharedPointer<NotationMove> tempMove = move;
+    NotationMovePtr tempMove = move;
+    int depth = 0;
     while(tempMove->m_previousMove){
         tempMove = tempMove->m_previousMove;
+        depth++;
     }
-    linkMoves(m_selectedMove, tempMove);
-    move->m_nextMoves.clear();
-    m_selectedMove = move;
+    move->clearNextMoves();
+    // the engine line is copied into the game tree, select the copy of the clicked move
+    NotationMovePtr linked = linkMoves(m_selectedMove, tempMove);
+    while (depth-- > 0 && !linked->nextMoves().isEmpty()){
+        linked = linked->nextMoves().front();
+    }
+    m_selectedMove = linked;
     emit moveSelected(m_selectedMove);
     refresh();
 }
@@ -318,7 +324,7 @@ void NotationViewer::onEngineMoveClicked(QSharedPointer<NotationMove> &move) {
 void NotationViewer::contextMenuEvent(QContextMenuEvent *event) {
     QPoint pos = event->pos();
     pos.setY(pos.y() + verticalScrollBar()->value());
-    QSharedPointer<NotationMove> clickedMove;
+    NotationMovePtr clickedMove;
     for (const MoveSegment &seg : std::as_const(m_moveSegments)) {
         if (seg.rect.contains(pos)) {
             clickedMove = seg.move;
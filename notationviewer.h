@@ -16,7 +16,7 @@ March 18, 2025: File Creation
 // Holds layout info for each clickable move segment
 struct MoveSegment {
     QRect rect; // Bounding rectangle of the move text
-    QSharedPointer<NotationMove> move;
+    NotationMovePtr move;
 };
 
 class NotationViewer : public QAbstractScrollArea
@@ -25,24 +25,24 @@ class NotationViewer : public QAbstractScrollArea
 public:
     explicit NotationViewer(PGNGame game, QWidget* parent = nullptr);
 
-    void setRootMove(const QSharedPointer<NotationMove>& notation);
-    QSharedPointer<NotationMove> getRootMove();
-    QSharedPointer<NotationMove> getSelectedMove();
+    void setRootMove(const NotationMovePtr& notation);
+    NotationMovePtr getRootMove();
+    NotationMovePtr getSelectedMove();
 
     void refresh(bool refreshLayout = true);
 
     bool m_isEdited;
     PGNGame m_game;
-    QSharedPointer<NotationMove>  m_selectedMove; // Current move
+    NotationMovePtr  m_selectedMove; // Current move
 
 public slots:
     void selectPreviousMove();
     void selectNextMove();
-    void onEngineMoveClicked(QSharedPointer<NotationMove> &move);
+    void onEngineMoveClicked(NotationMovePtr &move);
 
 signals:
-    void moveSelected(QSharedPointer<NotationMove>& move);
-    void moveHovered(QSharedPointer<NotationMove>& move);
+    void moveSelected(NotationMovePtr& move);
+    void moveHovered(NotationMovePtr& move);
 
 protected:
     void paintEvent(QPaintEvent* event) override;
@@ -59,24 +59,24 @@ private slots:
 
 private:
     // DFS traverse notation tree
-    void drawNotation(QPainter& painter, const QSharedPointer<NotationMove>& currentMove, int indent, int& x, int& y, bool isMain, bool shouldDrawMove = true);
+    void drawNotation(QPainter& painter, const NotationMovePtr& currentMove, int indent, int& x, int& y, bool isMain, bool shouldDrawMove = true);
 
     // Draw individual move
-    void drawMove(QPainter& painter, const QSharedPointer<NotationMove>& currentMove, int indent, int& x, int& y, bool isMain);
+    void drawMove(QPainter& painter, const NotationMovePtr& currentMove, int indent, int& x, int& y, bool isMain);
 
     void clearLayout();
     void layoutNotation();
 
     void drawTextSegment(QPainter &painter, const QString &text, int x, int &y, int indent, int availableWidth, QRect &outRect);
 
-    QSharedPointer<NotationMove> m_rootMove;
+    NotationMovePtr m_rootMove;
     QList<MoveSegment> m_moveSegments;   // Clickable segments    
 
     // Parameters for drawing
     int m_indentStep;
     int m_lineSpacing;
 
-    QSharedPointer<NotationMove> m_lastHoveredMove;
+    NotationMovePtr m_lastHoveredMove;
 
 };
 
@@ -613,13 +613,13 @@ OpeningViewer::OpeningViewer(QWidget *parent)
     connect(mGamesList, &QTableWidget::itemClicked, this, &OpeningViewer::onGameSelected);
 }
 
-void OpeningViewer::onMoveSelected(QSharedPointer<NotationMove>& move)
+void OpeningViewer::onMoveSelected(NotationMovePtr& move)
 {
-    if (!move->m_zobristHash) move->m_zobristHash = move->m_position->computeZobrist();
+    if (!move->m_zobristHash) move->m_zobristHash = move->m_position.computeZobrist();
     updatePosition(move->m_zobristHash, move->m_position, move->moveText);
 }
 
-void OpeningViewer::updatePosition(const quint64 zobrist, QSharedPointer<ChessPosition> position, const QString moveText)
+void OpeningViewer::updatePosition(const quint64 zobrist, const ChessPosition &position, const QString moveText)
 {
     auto [winrate, openingIndex] = mOpeningInfo.getWinrate(zobrist);
     int total = winrate.whiteWin + winrate.blackWin + winrate.draw;
@@ -629,29 +629,32 @@ void OpeningViewer::updatePosition(const quint64 zobrist, QSharedPointer<ChessPo
     mMovesList->setSortingEnabled(false);
 
     QString nextNumPrefix;
-    int nextMoveNum = (position->getPlyCount())/2 + 1;
-    if (position->m_sideToMove == 'w') {
+    int nextMoveNum = (position.getPlyCount())/2 + 1;
+    if (position.sideToMove() == 'w') {
         nextNumPrefix = QString::number(nextMoveNum) + ".";
     } else {
         nextNumPrefix = QString::number(nextMoveNum) + "...";
     }
 
-    auto legalMoves = position->generateLegalMoves();
-    for (const auto [sr, sc, dr, dc, promo]: std::as_const(legalMoves)){
-        ChessPosition tempPos;
-        tempPos.copyFrom(*position);
-        tempPos.applyMove(sr, sc, dr, dc, QChar(promo));
-        auto [newWin, _] = mOpeningInfo.getWinrate(tempPos.computeZobrist());
+    // probe every child in place on one scratch board
+    BitboardPosition board = position.board();
+    MoveList legalMoves;
+    board.generateLegalMoves(legalMoves);
+    for (Move move : legalMoves){
+        UndoInfo undo;
+        board.makeMove(move, undo);
+        auto [newWin, _] = mOpeningInfo.getWinrate(board.key);
+        board.unmakeMove(move, undo);
         int total = newWin.whiteWin + newWin.blackWin + newWin.draw;
         if (total){
             float whitePct = newWin.whiteWin * 100.0 / total, blackPct = newWin.blackWin * 100.0 / total, drawPct = newWin.draw * 100.0 / total;
-            addMoveToList(QString(nextNumPrefix+position->lanToSan(sr, sc, dr, dc, QChar(promo))), total, whitePct, drawPct, blackPct, {sr, sc, dr, dc, promo});
+            addMoveToList(QString(nextNumPrefix+position.lanToSan(move)), total, whitePct, drawPct, blackPct, move);
         }
     }
 
     QString numPrefix;
-    int moveNum = (position->getPlyCount()-1)/2 + 1;
-    if (position->m_sideToMove == 'b') {
+    int moveNum = (position.getPlyCount()-1)/2 + 1;
+    if (position.sideToMove() == 'b') {
         numPrefix = QString::number(moveNum) + ".";
     } else {
         numPrefix = QString::number(moveNum) + "...";
@@ -844,7 +847,7 @@ void OpeningViewer::addGameToList(int index){
 }
 
 // helper
-void OpeningViewer::addMoveToList(const QString& move, int games, float whitePct, float drawPct, float blackPct, SimpleMove moveData)
+void OpeningViewer::addMoveToList(const QString& move, int games, float whitePct, float drawPct, float blackPct, Move moveData)
 {
     int row = mMovesList->rowCount();
     mMovesList->insertRow(row);
@@ -884,7 +887,7 @@ void OpeningViewer::onNextMoveSelected(QTableWidgetItem* item)
     if (!first) return;
     QVariant v = first->data(Qt::UserRole);
     if (!v.isValid()) return;
-    SimpleMove moveData = v.value<SimpleMove>();
+    Move moveData = v.value<Move>();
     emit moveClicked(moveData);
 }
 
@@ -85,13 +85,13 @@ class OpeningViewer : public QWidget
 public:
     explicit OpeningViewer(QWidget *parent = nullptr);
     
-    void updatePosition(const quint64 zobrist, QSharedPointer<ChessPosition> position, const QString moveText);
+    void updatePosition(const quint64 zobrist, const ChessPosition &position, const QString moveText);
 
 public slots:
-    void onMoveSelected(QSharedPointer<NotationMove>& move);
+    void onMoveSelected(NotationMovePtr& move);
 
 signals:
-    void moveClicked(const SimpleMove& moveData);
+    void moveClicked(Move moveData);
     void gameSelected(int gameId); 
 
 private slots:
@@ -105,7 +105,7 @@ private:
     QVector<PGNGame> loadGameHeadersBatch(const QString &path, const QVector<quint32> &ids);
     bool ensureHeaderOffsetsLoaded(const QString &path);
 
-    void addMoveToList(const QString& move, int games, float whitePct, float drawPct, float blackPct, SimpleMove moveData);
+    void addMoveToList(const QString& move, int games, float whitePct, float drawPct, float blackPct, Move moveData);
     void addGameToList(int index);
     void updateGamesList(const int openingIndex, const PositionWinrate winrate);
 
@@ -0,0 +1,76 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <vector>
+
+// Runs fn(begin, end) over contiguous chunks of [0, count) and returns once all of them are done.
+// Chunks finish in any order, so fn should write its results into per-index slots to keep the
+// input order. A private pool is used so this can also be called from a global pool thread.
+template <typename Fn>
+void parallelForChunks(qsizetype count, Fn fn, qsizetype minChunk = 64)
+{
+    const int threads = qMax(1, QThread::idealThreadCount());
+    if (count <= 0) return;
+    if (threads == 1 || count <= minChunk) {
+        fn(qsizetype(0), count);
+        return;
+    }
+
+    // a few chunks per thread keeps the cores busy when games differ in length
+    qsizetype chunks = qMin<qsizetype>(qsizetype(threads) * 4, (count + minChunk - 1) / minChunk);
+    qsizetype chunkSize = (count + chunks - 1) / chunks;
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    for (qsizetype begin = 0; begin < count; begin += chunkSize) {
+        qsizetype end = qMin(count, begin + chunkSize);
+        pool.start([&fn, begin, end]() { fn(begin, end); });
+    }
+    pool.waitForDone();
+}
+
+// Sorts [first, last) by less like std::sort: runs are sorted on all cores, then adjacent runs are
+// merged pairwise, each round of merges again on all cores
+template <typename It, typename Less>
+void parallelSort(It first, It last, Less less, qsizetype minRun = 4096)
+{
+    const qsizetype count = last - first;
+    const int threads = qMax(1, QThread::idealThreadCount());
+    if (threads == 1 || count <= minRun) {
+        std::sort(first, last, less);
+        return;
+    }
+
+    const qsizetype runs = qMin<qsizetype>(threads, (count + minRun - 1) / minRun);
+    const qsizetype runSize = (count + runs - 1) / runs;
+    // run i is [bounds[i], bounds[i + 1])
+    std::vector<qsizetype> bounds;
+    for (qsizetype begin = 0; begin < count; begin += runSize) bounds.push_back(begin);
+    bounds.push_back(count);
+
+    parallelForChunks(qsizetype(bounds.size()) - 1, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype run = begin; run < end; ++run) std::sort(first + bounds[run], first + bounds[run + 1], less);
+    }, 1);
+    while (bounds.size() > 2) {
+        parallelForChunks(qsizetype(bounds.size() - 1) / 2, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype pair = begin; pair < end; ++pair) {
+                std::inplace_merge(first + bounds[2 * pair], first + bounds[2 * pair + 1], first + bounds[2 * pair + 2], less);
+            }
+        }, 1);
+        // a run left without a partner is carried over to the next round
+        std::vector<qsizetype> merged;
+        for (size_t i = 0; i < bounds.size(); i += 2) merged.push_back(bounds[i]);
+        if (merged.back() != count) merged.push_back(count);
+        bounds.swap(merged);
+    }
+}
+
+#endif // PARALLEL_H
@@ -0,0 +1,74 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "perft.h"
+#include "bitboard.h"
+#include "fastchessposition.h"
+
+#include <QElapsedTimer>
+#include <QTextStream>
+
+// BitboardPosition makes and unmakes in place; FastChessPosition plays every move on a copy like
+// the replay does, so both make paths are held to the reference counts
+static quint64 bitboardPerft(const BitboardPosition &board, int depth)
+{
+    BitboardPosition position = board;
+    return position.perft(depth);
+}
+
+static quint64 fastPerft(const BitboardPosition &board, int depth)
+{
+    FastChessPosition position;
+    position.setBoard(board);
+    return position.perft(depth);
+}
+
+struct PerftRunner {
+    const char *name;
+    quint64 (*perft)(const BitboardPosition &board, int depth);
+};
+
+static const PerftRunner PERFT_RUNNERS[] = {
+    {"BitboardPosition", bitboardPerft},
+    {"FastChessPosition", fastPerft},
+};
+
+int runPerftSuite()
+{
+    QTextStream out(stdout);
+    int failures = 0;
+
+    for (const PerftRunner &runner : PERFT_RUNNERS) {
+        quint64 totalNodes = 0;
+        qint64 totalNs = 0;
+
+        for (const PerftCase &test : PERFT_SUITE) {
+            BitboardPosition position;
+            if (!position.setFen(test.fen)) {
+                out << "FAIL " << test.name << ": could not parse FEN" << Qt::endl;
+                failures++;
+                continue;
+            }
+
+            QElapsedTimer timer;
+            timer.start();
+            quint64 nodes = runner.perft(position, test.depth);
+            qint64 ns = qMax<qint64>(timer.nsecsElapsed(), 1);
+            totalNodes += nodes;
+            totalNs += ns;
+
+            bool ok = (nodes == test.nodes);
+            if (!ok) failures++;
+            out << (ok ? "ok   " : "FAIL ") << runner.name << " " << test.name << " depth " << test.depth << ": " << nodes;
+            if (!ok) out << " (expected " << test.nodes << ")";
+            out << ", " << ns / 1000000 << " ms, " << qRound64(nodes * 1e9 / ns) << " nodes/s" << Qt::endl;
+        }
+
+        out << runner.name << ": " << totalNodes << " nodes, " << qRound64(totalNodes * 1e9 / qMax<qint64>(totalNs, 1))
+            << " nodes/s" << Qt::endl;
+    }
+
+    out << (failures ? "perft failed: " : "perft passed: ") << failures << " mismatches" << Qt::endl;
+    return failures;
+}
@@ -0,0 +1,42 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <QtGlobal>
+
+struct PerftCase {
+    const char *name;
+    const char *fen;
+    int depth;
+    quint64 nodes;
+};
+
+// Reference counts from the chessprogramming wiki perft results
+inline constexpr PerftCase PERFT_SUITE[] = {
+    {"start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603},
+    {"en passant pins", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+    {"promotions", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333},
+    {"promotion captures", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487},
+    {"middlegame", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594},
+    {"underpromotions", "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1", 5, 3605103},
+    {"en passant discovered check", "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888},
+    {"en passant into check", "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467},
+    {"short castling gives check", "5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072},
+    {"castling rights", "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206},
+};
+
+// Runs the perft suite through BitboardPosition and FastChessPosition and prints node counts and speed.
+// Needs only the position sources, so the console perft test links it without the GUI.
+// Returns the number of node counts that did not match
+int runPerftSuite();
+
+// SAN cross-check between ChessPosition and FastChessPosition and the FEN codec benchmark over
+// the suite positions, see perftnotation.cpp. Run after runPerftSuite() by ChessMD --perft.
+// Returns the number of SAN mismatches and FEN round trips that did not reproduce their input
+int runNotationChecks();
+
+#endif // PERFT_H
@@ -0,0 +1,16 @@
+/*
+October 17, 2026: File Creation
+*/
+
+// Console perft run for ctest, built from the position sources only so it needs no display.
+// The SAN and FEN checks that need the notation code run from ChessMD --perft
+
+#include "perft.h"
+#include "bitboard.h"
+
+int main()
+{
+    initZobristTables();
+    initAttackTables();
+    return runPerftSuite() ? 1 : 0;
+}
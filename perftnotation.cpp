@@ -0,0 +1,108 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "perft.h"
+#include "bitboard.h"
+#include "chessposition.h"
+#include "notation.h"
+#include "fastchessposition.h"
+
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include <cstring>
+
+// Every legal move must survive ChessPosition SAN output, decode back to the same move in
+// FastChessPosition and replay through ChessPosition::tryMakeMove to the same move and zobrist key.
+// The move built from its squares, as the board builds it, must be the same move with the same SAN
+static int crossCheckSan(const BitboardPosition &board, int depth, QTextStream &out, quint64 &checked)
+{
+    int failures = 0;
+    ChessPosition position;
+    position.setBoard(board);
+    FastChessPosition fast;
+    fast.setFen(position.positionToFEN());
+
+    MoveList moves;
+    board.generateLegalMoves(moves);
+    for (Move move : moves) {
+        QString san = position.lanToSan(move);
+        BitboardPosition next = board;
+        UndoInfo undo;
+        next.makeMove(move, undo);
+        checked++;
+
+        if (fast.sanToMove(san) != move) {
+            out << "FAIL FastChessPosition decoded " << san << " differently in " << position.positionToFEN() << Qt::endl;
+            failures++;
+        }
+        NotationMovePtr child = NotationMove::create(san, position);
+        if (!child->m_position.tryMakeMove(san, child) || child->m_move != move || child->m_position.computeZobrist() != next.key) {
+            out << "FAIL ChessPosition replayed " << san << " differently in " << position.positionToFEN() << Qt::endl;
+            failures++;
+        }
+        const int from = moveFrom(move), to = moveTo(move);
+        const QChar promo = movePromotion(move) != PAWN ? QChar("pnbrqk"[movePromotion(move)]) : QChar('\0');
+        Move built = squaresToMove(rowOf(from), colOf(from), rowOf(to), colOf(to), promo);
+        if (built != move || position.lanToSan(built) != san) {
+            out << "FAIL move built from the squares of " << san << " differs in " << position.positionToFEN() << Qt::endl;
+            failures++;
+        }
+        if (depth > 1) failures += crossCheckSan(next, depth - 1, out, checked);
+    }
+    return failures;
+}
+
+// FEN parse + serialize round trips over the suite positions, and positionToFEN as called per move.
+// A record that does not serialize back to its input counts as a failure.
+static int benchmarkFen(QTextStream &out)
+{
+    const int ROUNDS = 20000;
+    int failures = 0;
+    quint64 records = 0;
+    qint64 codecNs = 0, positionNs = 0;
+    char fen[FEN_BUFFER_SIZE];
+
+    for (const PerftCase &test : PERFT_SUITE) {
+        BitboardPosition board;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < ROUNDS; i++) {
+            board.setFen(test.fen);
+            board.writeFen(fen);
+        }
+        codecNs += timer.nsecsElapsed();
+        if (std::strcmp(fen, test.fen) != 0) {
+            out << "FAIL FEN round trip of " << test.name << " gave " << fen << Qt::endl;
+            failures++;
+        }
+
+        ChessPosition position;
+        position.setBoard(board);
+        timer.restart();
+        for (int i = 0; i < ROUNDS; i++) position.positionToFEN();
+        positionNs += timer.nsecsElapsed();
+        records += ROUNDS;
+    }
+
+    out << (failures ? "FAIL " : "ok   ") << "FEN codec: " << qRound64(records * 1e9 / qMax<qint64>(codecNs, 1))
+        << " round trips/s, positionToFEN: " << qRound64(records * 1e9 / qMax<qint64>(positionNs, 1)) << " calls/s" << Qt::endl;
+    return failures;
+}
+
+int runNotationChecks()
+{
+    QTextStream out(stdout);
+
+    // SAN round trip between ChessPosition and FastChessPosition, two plies deep from every suite position
+    quint64 checked = 0;
+    int failures = 0;
+    for (const PerftCase &test : PERFT_SUITE) {
+        BitboardPosition position;
+        if (position.setFen(test.fen)) failures += crossCheckSan(position, 2, out, checked);
+    }
+    out << (failures ? "FAIL " : "ok   ") << "SAN cross-check: " << checked << " moves, " << failures << " mismatches" << Qt::endl;
+
+    return failures + benchmarkFen(out);
+}
@@ -0,0 +1,35 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "pgnfile.h"
+
+PGNFile::PGNFile(const QString &path)
+    : m_file(path)
+{
+    if (!m_file.open(QIODevice::ReadOnly)) return;
+    m_open = true;
+    m_size = m_file.size();
+    if (m_size == 0) return;
+
+    uchar *mapped = m_file.map(0, m_size);
+    if (mapped) {
+        m_data = reinterpret_cast<const char*>(mapped);
+    } else {
+        // some file systems cannot be mapped, read the file once instead
+        m_fallback = m_file.readAll();
+        m_data = m_fallback.constData();
+        m_size = m_fallback.size();
+    }
+}
+
+PGNFile::~PGNFile()
+{
+    if (m_data && m_fallback.isEmpty()) m_file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(m_data)));
+}
+
+QString PGNFile::decode(PGNSpan span) const
+{
+    std::string_view bytes = view(span);
+    return QString::fromUtf8(bytes.data(), static_cast<qsizetype>(bytes.size()));
+}
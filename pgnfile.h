@@ -0,0 +1,44 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef PGNFILE_H
+#define PGNFILE_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+
+#include <string_view>
+
+// Byte range inside a PGN file
+struct PGNSpan {
+    qint64 offset = 0;
+    qint64 length = 0;
+};
+
+// Read-only memory mapping of a PGN file. Games parsed from it hold byte spans into the
+// mapping and a shared pointer keeping it alive, instead of their own copies of the text
+class PGNFile
+{
+public:
+    explicit PGNFile(const QString &path);
+    ~PGNFile();
+
+    bool isOpen() const { return m_open; }
+    std::string_view view() const { return std::string_view(m_data, static_cast<size_t>(m_size)); }
+    std::string_view view(PGNSpan span) const { return view().substr(span.offset, span.length); }
+
+    // UTF-8 decode of a span
+    QString decode(PGNSpan span) const;
+
+private:
+    QFile m_file;
+    // Filled only when the file cannot be mapped
+    QByteArray m_fallback;
+    const char *m_data = nullptr;
+    qint64 m_size = 0;
+    bool m_open = false;
+};
+
+#endif // PGNFILE_H
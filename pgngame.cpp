@@ -16,8 +16,8 @@ PGNGame::PGNGame()
     bodyText = "";
     isParsed = false;
     ChessPosition startPos;
-    rootMove = QSharedPointer<NotationMove>::create("", startPos);
-    rootMove->m_zobristHash = rootMove->m_position->computeZobrist();
+    rootMove = NotationMove::create("", startPos);
+    rootMove->m_zobristHash = rootMove->m_position.computeZobrist();
 }
 
 void PGNGame::copyFrom(PGNGame &other)
@@ -25,12 +25,28 @@ void PGNGame::copyFrom(PGNGame &other)
     headerInfo = other.headerInfo;
     result = other.result;
     bodyText = other.bodyText;
+    source = other.source;
+    bodySpan = other.bodySpan;
     dbIndex = other.dbIndex;
     isParsed = other.isParsed;
     rootMove = cloneNotationTree(other.rootMove);
 }
 
+QString PGNGame::body() const
+{
+    if (source.isNull()) return bodyText;
+    return source->decode(bodySpan);
+}
+
+void PGNGame::loadBody()
+{
+    if (source.isNull()) return;
+    bodyText = body();
+    source.reset();
+}
+
 QString PGNGame::serializePGN(){
+    loadBody();
     QString PGNtext;
     for (auto &kv: headerInfo){
         PGNtext += "[" + kv.first + " \"" + kv.second + "\"]\n";
@@ -74,7 +90,7 @@ bool PGNGame::serializeHeaderData(const QString &path, const std::vector<PGNGame
         }
         
         out << white << whiteElo << black << blackElo << event << date << game.result;
-        out << game.bodyText;
+        out << game.body();
     }
     
     // write offsets
@@ -8,6 +8,7 @@ April 20, 2025: Overhauled C++ headers with Qt framework
 #define PGNGAME_H
 
 #include "notation.h"
+#include "pgnfile.h"
 
 class PGNGame
 {
@@ -15,12 +16,19 @@ public:
     PGNGame();
     void copyFrom(PGNGame &other);
     QString serializePGN();
+    // Movetext, decoded from the source file when it has not been loaded yet
+    QString body() const;
+    // Decodes the movetext into bodyText once and releases the source file
+    void loadBody();
     static bool serializeHeaderData(const QString &path, const std::vector<PGNGame> &games);
 
-    QSharedPointer<NotationMove> rootMove;
+    NotationMovePtr rootMove;
     QVector<QPair<QString,QString>> headerInfo;
     QString result;
     QString bodyText;
+    // Movetext of a game read from a mapped file stays in the file until loadBody()
+    QSharedPointer<PGNFile> source;
+    PGNSpan bodySpan;
     int dbIndex;
     bool isParsed;
 };
@@ -0,0 +1,357 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "pgnindex.h"
+
+#include "parallel.h"
+
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QBuffer>
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+// Written in native byte order; an index from another machine fails the magic check and is rebuilt
+static const quint32 INDEX_MAGIC = 0x31494750; // "PGI1"
+static const quint32 INDEX_VERSION = 5;
+// Bytes hashed at each end of the PGN, hashing the whole file would cost as much as parsing it
+static const qint64 FINGERPRINT_SAMPLE = 64 * 1024;
+// Postings merged between two writes of the index
+static const size_t MERGE_BLOCK = 64 * 1024;
+
+struct PGNIndex::Header {
+    quint32 magic;
+    quint32 version;
+    qint64 sourceSize;
+    qint64 sourceModified;
+    quint64 sourceFingerprint;
+    quint64 gameCount;
+    // padded to a multiple of 8 so the position keys after the strings are aligned
+    quint64 stringsSize;
+    quint64 postingCount;
+};
+
+// Header tags of a game are stored at headersOffset as headerCount pairs of
+// length prefixed UTF-8 strings, tag then value
+struct PGNIndex::Entry {
+    qint64 bodyOffset;
+    qint64 bodyLength;
+    quint64 headersOffset;
+    quint32 headerCount;
+    qint32 plyCount;
+};
+
+// FNV-1a over both ends of the file
+static quint64 fingerprint(const PGNFile &file)
+{
+    std::string_view text = file.view();
+    quint64 hash = 14695981039346656037ULL;
+    auto add = [&hash](std::string_view bytes) {
+        for (char c : bytes) {
+            hash ^= static_cast<uchar>(c);
+            hash *= 1099511628211ULL;
+        }
+    };
+    const size_t sample = static_cast<size_t>(FINGERPRINT_SAMPLE);
+    if (text.size() <= 2 * sample) {
+        add(text);
+    } else {
+        add(text.substr(0, sample));
+        add(text.substr(text.size() - sample));
+    }
+    return hash;
+}
+
+static qint64 modifiedTime(const QString &path)
+{
+    return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+}
+
+static void appendString(QByteArray &strings, const QString &text)
+{
+    QByteArray utf8 = text.toUtf8();
+    quint32 size = static_cast<quint32>(utf8.size());
+    strings.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    strings.append(utf8);
+}
+
+PGNIndex::PGNIndex(const QString &pgnPath)
+    : m_pgnPath(pgnPath)
+    , m_file(sidecarPath(pgnPath))
+{
+    if (!m_file.open(QIODevice::ReadOnly)) return;
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(sizeof(Header))) return;
+    m_data = m_file.map(0, m_size);
+}
+
+PGNIndex::PGNIndex(const QString &pgnPath, const QByteArray &contents)
+    : m_pgnPath(pgnPath)
+    , m_contents(contents)
+{
+    if (m_contents.size() < static_cast<qsizetype>(sizeof(Header))) return;
+    m_data = reinterpret_cast<const uchar*>(m_contents.constData());
+    m_size = m_contents.size();
+}
+
+PGNIndex::~PGNIndex()
+{
+    if (m_data && m_file.isOpen()) m_file.unmap(const_cast<uchar*>(m_data));
+}
+
+QString PGNIndex::sidecarPath(const QString &pgnPath)
+{
+    return pgnPath + ".pgi";
+}
+
+const PGNIndex::Header *PGNIndex::header() const
+{
+    return reinterpret_cast<const Header*>(m_data);
+}
+
+const PGNIndex::Entry *PGNIndex::entries() const
+{
+    return reinterpret_cast<const Entry*>(m_data + sizeof(Header));
+}
+
+const char *PGNIndex::strings() const
+{
+    return reinterpret_cast<const char*>(entries() + header()->gameCount);
+}
+
+const quint64 *PGNIndex::positionKeys() const
+{
+    return reinterpret_cast<const quint64*>(strings() + header()->stringsSize);
+}
+
+const quint32 *PGNIndex::postings() const
+{
+    return reinterpret_cast<const quint32*>(positionKeys() + header()->postingCount);
+}
+
+bool PGNIndex::matches(const PGNFile &file) const
+{
+    if (!m_data || !file.isOpen()) return false;
+
+    const Header *h = header();
+    if (h->magic != INDEX_MAGIC || h->version != INDEX_VERSION) return false;
+    // the sections must fill the file exactly, anything else is a truncated or foreign file
+    quint64 available = static_cast<quint64>(m_size) - sizeof(Header);
+    if (h->gameCount > available / sizeof(Entry)) return false;
+    available -= h->gameCount * sizeof(Entry);
+    if (h->stringsSize > available || h->stringsSize % sizeof(quint64)) return false;
+    available -= h->stringsSize;
+    const quint64 postingSize = sizeof(quint64) + sizeof(quint32);
+    if (available % postingSize || h->postingCount != available / postingSize) return false;
+
+    const qint64 sourceSize = static_cast<qint64>(file.view().size());
+    return h->sourceSize == sourceSize
+        && h->sourceModified == modifiedTime(m_pgnPath)
+        && h->sourceFingerprint == fingerprint(file);
+}
+
+qsizetype PGNIndex::size() const
+{
+    return m_data ? static_cast<qsizetype>(header()->gameCount) : 0;
+}
+
+PGNGameRecord PGNIndex::record(qsizetype game) const
+{
+    PGNGameRecord record;
+    const Entry &entry = entries()[game];
+    const qint64 sourceSize = header()->sourceSize;
+    if (entry.bodyOffset >= 0 && entry.bodyLength >= 0 && entry.bodyOffset <= sourceSize && entry.bodyLength <= sourceSize - entry.bodyOffset) {
+        record.bodySpan = {entry.bodyOffset, entry.bodyLength};
+    }
+    record.plyCount = entry.plyCount;
+
+    const char *text = strings();
+    const quint64 end = header()->stringsSize;
+    quint64 pos = entry.headersOffset;
+    auto readString = [&](QString &out) {
+        quint32 size;
+        if (pos + sizeof(size) > end) return false;
+        std::memcpy(&size, text + pos, sizeof(size));
+        pos += sizeof(size);
+        if (pos + size > end) return false;
+        out = QString::fromUtf8(text + pos, static_cast<qsizetype>(size));
+        pos += size;
+        return true;
+    };
+
+    record.headerInfo.reserve(entry.headerCount);
+    for (quint32 i = 0; i < entry.headerCount; i++) {
+        QString tag, value;
+        if (!readString(tag) || !readString(value)) break;
+        if (tag == "Result") record.result = value;
+        record.headerInfo.push_back({tag, value});
+    }
+    return record;
+}
+
+std::pair<const quint32*, const quint32*> PGNIndex::postingsOf(quint64 position) const
+{
+    if (!m_data) return {nullptr, nullptr};
+    const quint64 *keys = positionKeys();
+    auto [first, last] = std::equal_range(keys, keys + header()->postingCount, position);
+    return {postings() + (first - keys), postings() + (last - keys)};
+}
+
+std::vector<quint32> PGNIndex::gamesReaching(quint64 position) const
+{
+    auto [begin, end] = postingsOf(position);
+    return std::vector<quint32>(begin, end);
+}
+
+bool PGNIndex::reaches(qsizetype game, quint64 position) const
+{
+    auto [begin, end] = postingsOf(position);
+    return std::binary_search(begin, end, static_cast<quint32>(game));
+}
+
+PGNIndex::Builder::Builder(const QString &pgnPath, const PGNFile &file)
+    : m_pgnPath(pgnPath)
+    , m_file(file)
+{
+}
+
+void PGNIndex::Builder::add(const std::vector<PGNGameRecord> &records, const std::vector<QVector<quint64>> &positions)
+{
+    for (const PGNGameRecord &record : records) {
+        Entry entry;
+        entry.bodyOffset = record.bodySpan.offset;
+        entry.bodyLength = record.bodySpan.length;
+        entry.headersOffset = static_cast<quint64>(m_strings.size());
+        entry.headerCount = static_cast<quint32>(record.headerInfo.size());
+        entry.plyCount = record.plyCount;
+        for (const auto &header : record.headerInfo) {
+            appendString(m_strings, header.first);
+            appendString(m_strings, header.second);
+        }
+        m_entries.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+
+    std::vector<std::pair<quint64, quint32>> pairs;
+    for (size_t game = 0; game < positions.size() && game < records.size(); game++) {
+        const quint32 id = static_cast<quint32>(m_gameCount + game);
+        for (quint64 position : positions[game]) pairs.push_back({position, id});
+    }
+    m_gameCount += records.size();
+    if (pairs.empty()) return;
+
+    // sorted by position, the games of a position stay in order
+    parallelSort(pairs.begin(), pairs.end(), std::less<std::pair<quint64, quint32>>());
+    const quint64 count = pairs.size();
+    QByteArray run;
+    run.reserve(static_cast<qsizetype>(count * (sizeof(quint64) + sizeof(quint32)) + sizeof(quint32)));
+    for (const auto &pair : pairs) run.append(reinterpret_cast<const char*>(&pair.first), sizeof(quint64));
+    for (const auto &pair : pairs) run.append(reinterpret_cast<const char*>(&pair.second), sizeof(quint32));
+    // keeps the keys of the next run aligned
+    while (run.size() % static_cast<qsizetype>(sizeof(quint64))) run.append('\0');
+    m_postingCount += count;
+
+    if (!m_spillFailed && (m_runFile.isOpen() || m_runFile.open()) && m_runFile.write(run) == run.size()) {
+        m_runs.push_back({true, m_runFileSize, count});
+        m_runFileSize += run.size();
+    } else {
+        // a full or missing temporary folder leaves the runs in memory, the ones in the file stay valid
+        m_spillFailed = true;
+        m_runs.push_back({false, static_cast<qint64>(m_runBuffer.size()), count});
+        m_runBuffer.append(run);
+    }
+}
+
+bool PGNIndex::Builder::write()
+{
+    QSaveFile out(sidecarPath(m_pgnPath));
+    if (!out.open(QIODevice::WriteOnly)) return false;
+    return writeTo(out) && out.commit();
+}
+
+QByteArray PGNIndex::Builder::contents()
+{
+    QByteArray contents;
+    QBuffer out(&contents);
+    out.open(QIODevice::WriteOnly);
+    if (!writeTo(out)) return QByteArray();
+    return contents;
+}
+
+bool PGNIndex::Builder::writeTo(QIODevice &out)
+{
+    QByteArray strings = m_strings;
+    while (strings.size() % static_cast<qsizetype>(sizeof(quint64))) strings.append('\0');
+
+    Header header;
+    header.magic = INDEX_MAGIC;
+    header.version = INDEX_VERSION;
+    header.sourceSize = static_cast<qint64>(m_file.view().size());
+    header.sourceModified = modifiedTime(m_pgnPath);
+    header.sourceFingerprint = fingerprint(m_file);
+    header.gameCount = m_gameCount;
+    header.stringsSize = static_cast<quint64>(strings.size());
+    header.postingCount = m_postingCount;
+    if (out.write(reinterpret_cast<const char*>(&header), sizeof(header)) != sizeof(header)
+        || out.write(m_entries) != m_entries.size() || out.write(strings) != strings.size()) return false;
+
+    // the spilled runs are read back through a mapping, they are never loaded as a whole
+    const uchar *mapped = nullptr;
+    if (m_runFileSize > 0) {
+        if (!m_runFile.flush() || !(mapped = m_runFile.map(0, m_runFileSize))) return false;
+    }
+
+    // one cursor per run; the smallest key comes first, and of equal keys the one of the earlier
+    // run, whose games come before those of later runs
+    struct Cursor {
+        const quint64 *key;
+        const quint64 *keyEnd;
+        const quint32 *game;
+    };
+    std::vector<Cursor> cursors;
+    using Head = std::pair<quint64, size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    for (const Run &run : m_runs) {
+        const uchar *data = run.inFile ? mapped : reinterpret_cast<const uchar*>(m_runBuffer.constData());
+        const quint64 *keys = reinterpret_cast<const quint64*>(data + run.offset);
+        cursors.push_back({keys, keys + run.count, reinterpret_cast<const quint32*>(keys + run.count)});
+        heads.push({*keys, cursors.size() - 1});
+    }
+
+    // keys and games are written to their own sections a block at a time
+    qint64 keysAt = out.pos();
+    qint64 gamesAt = keysAt + static_cast<qint64>(m_postingCount * sizeof(quint64));
+    std::vector<quint64> keys;
+    std::vector<quint32> games;
+    keys.reserve(MERGE_BLOCK);
+    games.reserve(MERGE_BLOCK);
+    auto flush = [&]() {
+        const qint64 keyBytes = static_cast<qint64>(keys.size() * sizeof(quint64));
+        const qint64 gameBytes = static_cast<qint64>(games.size() * sizeof(quint32));
+        const bool written = out.seek(keysAt) && out.write(reinterpret_cast<const char*>(keys.data()), keyBytes) == keyBytes
+                             && out.seek(gamesAt) && out.write(reinterpret_cast<const char*>(games.data()), gameBytes) == gameBytes;
+        keysAt += keyBytes;
+        gamesAt += gameBytes;
+        keys.clear();
+        games.clear();
+        return written;
+    };
+
+    bool written = true;
+    while (!heads.empty() && written) {
+        const size_t run = heads.top().second;
+        heads.pop();
+        Cursor &cursor = cursors[run];
+        keys.push_back(*cursor.key++);
+        games.push_back(*cursor.game++);
+        if (cursor.key != cursor.keyEnd) heads.push({*cursor.key, run});
+        if (keys.size() == MERGE_BLOCK) written = flush();
+    }
+    if (written) written = flush();
+
+    if (mapped) m_runFile.unmap(const_cast<uchar*>(mapped));
+    return written;
+}
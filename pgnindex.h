@@ -0,0 +1,110 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef PGNINDEX_H
+#define PGNINDEX_H
+
+#include <QFile>
+#include <QTemporaryFile>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <vector>
+
+#include "pgnfile.h"
+#include "streamparser.h"
+
+// Sidecar index written next to a PGN file (<file>.pgi) after it has been imported once. It holds
+// the header tags, movetext span and mainline length of every game together with the size,
+// modification time and a fingerprint of the PGN, so reopening an unchanged file reads the
+// memory mapped index instead of parsing the PGN again. It also maps every position reached by
+// a mainline to the games reaching it, one (placement key, game) posting per position a
+// game reaches, sorted by key and then by game; see BitboardPosition::placementKey()
+class PGNIndex
+{
+public:
+    explicit PGNIndex(const QString &pgnPath);
+    // An index kept in memory, for databases whose folder cannot be written to
+    PGNIndex(const QString &pgnPath, const QByteArray &contents);
+    ~PGNIndex();
+
+    // True when the index exists and was written for file as it is now
+    bool matches(const PGNFile &file) const;
+
+    qsizetype size() const;
+    // Decodes one game; safe to call from several threads at once
+    PGNGameRecord record(qsizetype game) const;
+
+    // Games whose mainline reaches the position with placement key position, in order
+    std::vector<quint32> gamesReaching(quint64 position) const;
+    bool reaches(qsizetype game, quint64 position) const;
+
+    static QString sidecarPath(const QString &pgnPath);
+
+    // Collects the index of a PGN one batch of games at a time, in the encoded form the index
+    // stores, so an import does not keep the games it has already handed to the table. The
+    // postings of each batch are sorted and spilled to a temporary file, and the sorted runs
+    // are merged straight into the index when it is written
+    class Builder
+    {
+    public:
+        Builder(const QString &pgnPath, const PGNFile &file);
+
+        // Appends records, which must carry their plyCount; positions[i] holds the placement
+        // keys of the mainline of records[i], sorted without repeats
+        void add(const std::vector<PGNGameRecord> &records, const std::vector<QVector<quint64>> &positions);
+        // Replaces the sidecar of the PGN with the index of the games added so far, readers
+        // never see a half written index
+        bool write();
+        // Index contents of the games added so far, for an index kept in memory
+        QByteArray contents();
+
+    private:
+        // count postings of one batch, their keys followed by their games
+        struct Run {
+            bool inFile;
+            qint64 offset;
+            quint64 count;
+        };
+
+        bool writeTo(QIODevice &out);
+
+        QString m_pgnPath;
+        const PGNFile &m_file;
+        quint64 m_gameCount = 0;
+        QByteArray m_entries;
+        QByteArray m_strings;
+        std::vector<Run> m_runs;
+        quint64 m_postingCount = 0;
+        QTemporaryFile m_runFile;
+        // bytes of whole runs in m_runFile
+        qint64 m_runFileSize = 0;
+        // runs are kept in m_runBuffer once the temporary file cannot be written
+        bool m_spillFailed = false;
+        QByteArray m_runBuffer;
+    };
+
+private:
+    struct Header;
+    struct Entry;
+
+    const Header *header() const;
+    const Entry *entries() const;
+    const char *strings() const;
+    // postingCount keys, the game of key i is postings()[i]
+    const quint64 *positionKeys() const;
+    const quint32 *postings() const;
+    // Posting list of position, empty when no game reaches it
+    std::pair<const quint32*, const quint32*> postingsOf(quint64 position) const;
+
+    QString m_pgnPath;
+    QFile m_file;
+    // Holds the contents of an index that is not mapped
+    QByteArray m_contents;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+};
+
+#endif // PGNINDEX_H
@@ -0,0 +1,271 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "pgntokenizer.h"
+#include "bitboard.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define PGN_TOKENIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(PGN_TOKENIZER_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define PGN_TOKENIZER_AVX2
+#include <immintrin.h>
+#endif
+
+static inline unsigned charCode(char c) { return static_cast<unsigned char>(c); }
+static inline unsigned charCode(char16_t c) { return c; }
+
+// Only ASCII whitespace separates tokens: space and \t \n \v \f \r
+static inline bool isSpaceCode(unsigned c) { return c == ' ' || c - 9 <= 4; }
+
+static inline bool isDelimiterCode(unsigned c)
+{
+    return isSpaceCode(c) || c == '{' || c == '}' || c == '(' || c == ')' || c == ';' || c == '$';
+}
+
+// Whitespace and delimiter bits for 64 characters starting at base
+struct BlockMasks {
+    quint64 space;
+    quint64 delimiter;
+};
+
+template <typename Char>
+static BlockMasks classifyScalar(const Char *text, size_t base, size_t n)
+{
+    // past the end counts as a delimiter that is not whitespace, so every search stops at n
+    BlockMasks masks = {0, 0};
+    for (size_t i = 0; i < 64; i++) {
+        if (base + i >= n) {
+            masks.delimiter |= 1ULL << i;
+            continue;
+        }
+        unsigned c = charCode(text[base + i]);
+        if (isSpaceCode(c)) masks.space |= 1ULL << i;
+        if (isDelimiterCode(c)) masks.delimiter |= 1ULL << i;
+    }
+    return masks;
+}
+
+template <typename Char>
+static size_t findScalar(const Char *text, size_t pos, size_t n, char target)
+{
+    while (pos < n && charCode(text[pos]) != charCode(target)) ++pos;
+    return pos;
+}
+
+#ifdef PGN_TOKENIZER_SSE2
+// UTF-16 is narrowed to bytes with unsigned saturation; anything outside ASCII saturates to 0x00
+// or 0xFF, neither of which is a delimiter, so one byte classifier serves both encodings
+static inline __m128i loadSse2(const char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+static inline __m128i loadSse2(const char16_t *p)
+{
+    return _mm_packus_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8)));
+}
+
+static inline void classifySse2(__m128i v, unsigned &space, unsigned &delimiter)
+{
+    // \t..\r is (v - 9) <= 4 as unsigned bytes
+    __m128i control = _mm_sub_epi8(v, _mm_set1_epi8(9));
+    control = _mm_cmpeq_epi8(_mm_min_epu8(control, _mm_set1_epi8(4)), control);
+    __m128i spaces = _mm_or_si128(control, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+    __m128i brackets = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('{')), _mm_cmpeq_epi8(v, _mm_set1_epi8('}'))),
+                                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('(')), _mm_cmpeq_epi8(v, _mm_set1_epi8(')'))));
+    __m128i other = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(';')), _mm_cmpeq_epi8(v, _mm_set1_epi8('$')));
+    space = _mm_movemask_epi8(spaces);
+    delimiter = _mm_movemask_epi8(_mm_or_si128(spaces, _mm_or_si128(brackets, other)));
+}
+
+template <typename Char>
+static BlockMasks classifySse2(const Char *text, size_t base, size_t n)
+{
+    if (base + 64 > n) return classifyScalar(text, base, n);
+    BlockMasks masks = {0, 0};
+    for (int i = 0; i < 64; i += 16) {
+        unsigned space, delimiter;
+        classifySse2(loadSse2(text + base + i), space, delimiter);
+        masks.space |= quint64(space) << i;
+        masks.delimiter |= quint64(delimiter) << i;
+    }
+    return masks;
+}
+
+template <typename Char>
+static size_t findSse2(const Char *text, size_t pos, size_t n, char target)
+{
+    for (; pos + 16 <= n; pos += 16) {
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(loadSse2(text + pos), _mm_set1_epi8(target)));
+        if (mask) return pos + lsb(mask);
+    }
+    return findScalar(text, pos, n, target);
+}
+#endif
+
+#ifdef PGN_TOKENIZER_AVX2
+__attribute__((target("avx2"))) static inline __m256i loadAvx2(const char *p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// packus works per 128-bit lane, the permute restores character order
+__attribute__((target("avx2"))) static inline __m256i loadAvx2(const char16_t *p)
+{
+    __m256i packed = _mm256_packus_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+                                         _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 16)));
+    return _mm256_permute4x64_epi64(packed, 0xD8);
+}
+
+__attribute__((target("avx2"))) static inline void classifyAvx2(__m256i v, quint32 &space, quint32 &delimiter)
+{
+    __m256i control = _mm256_sub_epi8(v, _mm256_set1_epi8(9));
+    control = _mm256_cmpeq_epi8(_mm256_min_epu8(control, _mm256_set1_epi8(4)), control);
+    __m256i spaces = _mm256_or_si256(control, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+    __m256i brackets = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('}'))),
+                                       _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('(')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(')'))));
+    __m256i other = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(';')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('$')));
+    space = static_cast<quint32>(_mm256_movemask_epi8(spaces));
+    delimiter = static_cast<quint32>(_mm256_movemask_epi8(_mm256_or_si256(spaces, _mm256_or_si256(brackets, other))));
+}
+
+template <typename Char>
+__attribute__((target("avx2"))) static BlockMasks classifyAvx2(const Char *text, size_t base, size_t n)
+{
+    if (base + 64 > n) return classifyScalar(text, base, n);
+    quint32 spaceLow, delimiterLow, spaceHigh, delimiterHigh;
+    classifyAvx2(loadAvx2(text + base), spaceLow, delimiterLow);
+    classifyAvx2(loadAvx2(text + base + 32), spaceHigh, delimiterHigh);
+    return {spaceLow | (quint64(spaceHigh) << 32), delimiterLow | (quint64(delimiterHigh) << 32)};
+}
+
+template <typename Char>
+__attribute__((target("avx2"))) static size_t findAvx2(const Char *text, size_t pos, size_t n, char target)
+{
+    for (; pos + 32 <= n; pos += 32) {
+        quint32 mask = static_cast<quint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(loadAvx2(text + pos), _mm256_set1_epi8(target))));
+        if (mask) return pos + lsb(mask);
+    }
+    return findSse2(text, pos, n, target);
+}
+
+static bool cpuHasAvx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static const bool s_useAvx2 = cpuHasAvx2();
+#endif
+
+template <typename Char>
+static inline BlockMasks classify(const Char *text, size_t base, size_t n)
+{
+#if defined(PGN_TOKENIZER_AVX2)
+    if (s_useAvx2) return classifyAvx2(text, base, n);
+#endif
+#if defined(PGN_TOKENIZER_SSE2)
+    return classifySse2(text, base, n);
+#else
+    return classifyScalar(text, base, n);
+#endif
+}
+
+// Index of the first target character at or after pos, n if there is none
+template <typename Char>
+static inline size_t find(const Char *text, size_t pos, size_t n, char target)
+{
+#if defined(PGN_TOKENIZER_AVX2)
+    if (s_useAvx2) return findAvx2(text, pos, n, target);
+#endif
+#if defined(PGN_TOKENIZER_SSE2)
+    return findSse2(text, pos, n, target);
+#else
+    return findScalar(text, pos, n, target);
+#endif
+}
+
+// Classifies 64 characters at a time and answers searches from the cached bitmasks,
+// so short tokens cost a shift and a bit scan instead of a vector load each
+template <typename Char>
+class MaskWindow
+{
+public:
+    MaskWindow(const Char *text, size_t n) : m_text(text), m_n(n) {}
+
+    size_t nextNonSpace(size_t pos) { return next<true>(pos); }
+    size_t nextDelimiter(size_t pos) { return next<false>(pos); }
+
+private:
+    template <bool NonSpace>
+    size_t next(size_t pos)
+    {
+        while (pos < m_n) {
+            if (pos - m_base >= 64) {
+                m_masks = classify(m_text, pos, m_n);
+                m_base = pos;
+            }
+            quint64 bits = (NonSpace ? ~m_masks.space : m_masks.delimiter) >> (pos - m_base);
+            if (bits) return qMin(pos + lsb(bits), m_n);
+            pos = m_base + 64;
+        }
+        return m_n;
+    }
+
+    const Char *m_text;
+    size_t m_n;
+    // base starts out of range so the first search classifies
+    size_t m_base = ~size_t(0) - 64;
+    BlockMasks m_masks = {0, 0};
+};
+
+template <typename Char>
+static void tokenize(const Char *text, size_t n, std::vector<PGNToken> &tokens)
+{
+    tokens.clear();
+    auto emitToken = [&](size_t offset, size_t length, PGNTokenType type) {
+        tokens.push_back({static_cast<qint32>(offset), static_cast<qint32>(length), type});
+    };
+
+    MaskWindow<Char> window(text, n);
+    size_t pos = 0;
+    while ((pos = window.nextNonSpace(pos)) < n) {
+        switch (charCode(text[pos])) {
+        case '{':
+        case ';': {
+            // brace comments run to the closing brace, semicolon comments to the end of the line
+            size_t end = find(text, pos + 1, n, charCode(text[pos]) == '{' ? '}' : '\n');
+            emitToken(pos + 1, end - pos - 1, PGN_COMMENT);
+            pos = (end < n ? end + 1 : n);
+            break;
+        }
+        case '(':
+            emitToken(pos++, 1, PGN_VARIATION_START);
+            break;
+        case ')':
+            emitToken(pos++, 1, PGN_VARIATION_END);
+            break;
+        case '}':
+            // stray closing brace
+            pos++;
+            break;
+        default: {
+            size_t end = window.nextDelimiter(pos + 1);
+            emitToken(pos, end - pos, charCode(text[pos]) == '$' ? PGN_NAG : PGN_WORD);
+            pos = end;
+            break;
+        }
+        }
+    }
+}
+
+void tokenizeMovetext(std::string_view text, std::vector<PGNToken> &tokens)
+{
+    tokenize(text.data(), text.size(), tokens);
+}
+
+void tokenizeMovetext(QStringView text, std::vector<PGNToken> &tokens)
+{
+    tokenize(reinterpret_cast<const char16_t*>(text.utf16()), static_cast<size_t>(text.size()), tokens);
+}
@@ -0,0 +1,34 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef PGNTOKENIZER_H
+#define PGNTOKENIZER_H
+
+#include <QtGlobal>
+#include <QStringView>
+
+#include <string_view>
+#include <vector>
+
+enum PGNTokenType : quint8 {
+    PGN_WORD,            // move number, SAN move or result
+    PGN_NAG,             // $ followed by a number
+    PGN_COMMENT,         // text inside {} or after ; up to the end of the line, delimiters excluded
+    PGN_VARIATION_START,
+    PGN_VARIATION_END
+};
+
+struct PGNToken {
+    qint32 offset;
+    qint32 length;
+    PGNTokenType type;
+};
+
+// Splits PGN movetext into tokens. Whitespace and delimiters are classified into bitmasks 64
+// characters at a time (SSE2, or AVX2 when the CPU has it) with a scalar fallback elsewhere.
+// tokens is cleared first, so callers can reuse one buffer across games to avoid reallocating it.
+void tokenizeMovetext(std::string_view text, std::vector<PGNToken> &tokens);
+void tokenizeMovetext(QStringView text, std::vector<PGNToken> &tokens);
+
+#endif // PGNTOKENIZER_H
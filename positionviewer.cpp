@@ -0,0 +1,109 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#include "positionviewer.h"
+
+PositionViewer::PositionViewer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void PositionViewer::setBoardData(const QVector<QVector<QString>> &data)
+{
+    if (m_position.setBoardData(data)) {
+        emit boardDataChanged();
+    }
+}
+
+QVector<QVector<QString>> PositionViewer::convertFenToBoardData(const QString &fen)
+{
+    return ::convertFenToBoardData(fen);
+}
+
+void PositionViewer::buildUserMove(int sr, int sc, int dr, int dc, QChar promo)
+{
+    buildUserMove(squaresToMove(sr, sc, dr, dc, promo));
+}
+
+void PositionViewer::buildUserMove(Move move)
+{
+    ChessPosition newPos = m_position;
+    newPos.applyMove(move);
+
+    QString moveText = m_position.lanToSan(move);
+    NotationMovePtr newMove = NotationMove::create(moveText, newPos);
+    newMove->m_move = move;
+    newMove->m_zobristHash = newPos.computeZobrist();
+
+    m_premoveEnabled = false;
+    emit moveMade(newMove);
+    emit boardDataChanged();
+}
+
+void PositionViewer::buildPremove(int sr, int sc, int dr, int dc, QChar promo)
+{
+    emit premoveMade({sr, sc, dr, dc, promo.toLatin1()});
+}
+
+void PositionViewer::release(int oldRow, int oldCol, int newRow, int newCol)
+{
+    if (m_premoveEnabled){
+        if (!m_position.validatePremove(oldRow, oldCol, newRow, newCol)){
+            return;
+        }
+        if (pieceType(m_position.board().pieceAt(squareOf(oldRow, oldCol))) == PAWN && (newRow == 0 || newRow == 7)){
+            emit requestPromotion(oldRow, oldCol, newRow, newCol);
+        } else {
+            buildPremove(oldRow, oldCol, newRow, newCol, '\0');
+        }
+        return;
+    }
+    if (!m_position.validateMove(oldRow, oldCol, newRow, newCol)){
+        return;
+    }
+    if (pieceType(m_position.board().pieceAt(squareOf(oldRow, oldCol))) == PAWN && (newRow == 0 || newRow == 7)){
+        emit requestPromotion(oldRow, oldCol, newRow, newCol);
+    } else {
+        buildUserMove(oldRow, oldCol, newRow, newCol, '\0');
+    }
+}
+
+void PositionViewer::promote(int sr, int sc, int dr, int dc, QChar promo)
+{
+    if (m_premoveEnabled){
+        buildPremove(sr, sc, dr, dc, promo);
+    } else {
+        buildUserMove(sr, sc, dr, dc, promo);
+    }
+}
+
+void PositionViewer::updatePremoves(QList<SimpleMove>& premoves)
+{
+    quint64 premoveSquare = 0;
+    for (int i = 0; i < premoves.size(); i++){
+        auto& [sr, sc, dr, dc, promo] = premoves[i];
+        if (m_position.board().pieceAt(squareOf(sr, sc)) == NO_PIECE){
+            premoves.resize(i); // remaining premoves invalid
+            break;
+        } else {
+            premoveSquare |= ((1ULL<<static_cast<quint64>(sr*8+sc)) | (1ULL<<static_cast<quint64>(dr*8+dc))); // a8 = 0, h1 = 63
+            m_position.relocatePiece(sr, sc, dr, dc);
+        }
+    }
+    emit boardDataChanged();
+    setPremoveSq(premoveSquare);
+}
+
+void PositionViewer::insertPremove(SimpleMove premove)
+{
+    quint64 premoveSquare = m_premoveSq;
+    auto& [sr, sc, dr, dc, promo] = premove;
+    int piece = m_position.board().pieceAt(squareOf(sr, sc));
+    if (piece != NO_PIECE && pieceColor(piece) != m_position.board().sideToMove){
+        premoveSquare |= ((1ULL<<static_cast<quint64>(sr*8+sc)) | (1ULL<<static_cast<quint64>(dr*8+dc))); // a8 = 0, h1 = 63
+        m_position.relocatePiece(sr, sc, dr, dc);
+        emit boardDataChanged();
+        setPremoveSq(premoveSquare);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+October 17, 2026: File Creation
+*/
+
+#ifndef POSITIONVIEWER_H
+#define POSITIONVIEWER_H
+
+#include <QObject>
+#include <QList>
+#include <QVector>
+
+#include "chessposition.h"
+#include "notation.h"
+
+// The board bound to QML. One per board, it shows a copy of the position of the selected move
+// together with the display state and turns moves made on the board into notation moves
+class PositionViewer: public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QVector<QVector<QString>> boardData READ boardData WRITE setBoardData NOTIFY boardDataChanged)
+    Q_PROPERTY(double evalScore READ evalScore WRITE setEvalScore NOTIFY evalScoreChanged)
+    Q_PROPERTY(bool isPreview READ isPreview WRITE setIsPreview NOTIFY isPreviewChanged)
+    Q_PROPERTY(bool isBoardFlipped READ isBoardFlipped NOTIFY isBoardFlippedChanged)
+    Q_PROPERTY(bool isEvalActive READ isEvalActive NOTIFY isEvalActiveChanged)
+    Q_PROPERTY(quint64 premoveSq READ getPremoveSq NOTIFY premoveSqChanged)
+    Q_PROPERTY(int lastMove READ lastMove NOTIFY lastMoveChanged)
+
+public:
+    explicit PositionViewer(QObject *parent = nullptr);
+
+    // The position on the board. Setting it does not signal, callers emit what changed
+    const ChessPosition& position() const { return m_position; }
+    void setPosition(const ChessPosition &position) { m_position = position; }
+
+    QVector<QVector<QString>> boardData() const { return m_position.boardData(); }
+    void setBoardData(const QVector<QVector<QString>> &data);
+
+    // Called from Qml when the user tries to make a new move
+    Q_INVOKABLE void release(int sr, int sc, int dr, int dc);
+    Q_INVOKABLE void promote(int sr, int sc, int dr, int dc, QChar promo);
+
+    // Called from QML to convert FEN string to board data
+    Q_INVOKABLE QVector<QVector<QString>> convertFenToBoardData(const QString &fen);
+
+    bool isPreview() const { return m_isPreview; }
+    void setIsPreview(bool p) {
+        if (m_isPreview == p) return;
+        m_isPreview = p;
+        emit isPreviewChanged(p);
+    }
+    bool isBoardFlipped() const { return m_isBoardFlipped; }
+    void flipBoard() {
+        m_isBoardFlipped = !m_isBoardFlipped;
+        emit isBoardFlippedChanged(m_isBoardFlipped);
+    }
+
+    int lastMove() const { return m_position.lastMove(); }
+
+    double evalScore() const { return m_position.evalScore(); }
+    void setEvalScore(double v) {
+        m_position.setEvalScore(v);
+        emit evalScoreChanged();
+    }
+
+    bool isEvalActive() const { return m_isEvalActive; }
+    void setIsEvalActive(bool p) {
+        if (m_isEvalActive == p) return;
+        m_isEvalActive = p;
+        emit isEvalActiveChanged(p);
+    }
+
+    quint64 getPremoveSq() const { return m_premoveSq; }
+    void setPremoveSq(quint64 v) {
+        if (m_premoveSq == v) return;
+        m_premoveSq = v;
+        emit premoveSqChanged();
+    }
+    Q_INVOKABLE bool isPremoveSquare(int row, int col) const {
+        if (row*8 + col < 0 || row*8 + col >= 64) return false;
+        return ((m_premoveSq >> static_cast<quint64>(row*8 + col)) & 1ULL) != 0ULL;
+    }
+
+    void buildUserMove(int sr, int sc, int dr, int dc, QChar promo);
+    void buildUserMove(Move move);
+    void buildPremove(int sr, int sc, int dr, int dc, QChar promo);
+    void insertPremove(SimpleMove premove);
+    void updatePremoves(QList<SimpleMove> &premoves);
+
+    bool m_premoveEnabled = false;
+
+signals:
+    // Signals QML to update board display
+    void boardDataChanged();
+    void requestPromotion(int sr, int sc, int dr, int dc);
+    // Signals ChessGameWindow to append new move to current selected move
+    void moveMade(NotationMovePtr& move);
+    void premoveMade(SimpleMove move);
+
+    void isPreviewChanged(bool);
+    void isBoardFlippedChanged(bool);
+    void isEvalActiveChanged(bool);
+    void premoveSqChanged();
+    void lastMoveChanged();
+    void evalScoreChanged();
+
+private:
+    ChessPosition m_position;
+
+    bool m_isPreview = false;
+    bool m_isBoardFlipped = false;
+    bool m_isEvalActive = false;
+    quint64 m_premoveSq = 0;
+};
+
+#endif // POSITIONVIEWER_H
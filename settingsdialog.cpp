@@ -2,6 +2,8 @@
 #include "streamparser.h"
 #include "chessqsettings.h"
 #include "openingviewer.h"
+#include "fastchessposition.h"
+#include "parallel.h"
 
 #include <QListWidget>
 #include <QStackedWidget>
@@ -16,7 +18,6 @@
 #include <QSettings>
 #include <QComboBox>
 #include <QTemporaryFile>
-#include <fstream>
 
 SettingsDialog::SettingsDialog(QWidget* parent)
     : QDialog(parent), mOpeningsPath("")
@@ -296,20 +297,15 @@ void SettingsDialog::reportProgress(qint64 bytesRead, qint64 total, QProgressBar
 void SettingsDialog::importPgnFileStreaming(const QString &file, QProgressBar *progressBar) {
     if (file.isEmpty()) return;
 
-    // open input file as binary
-    std::ifstream ss(file.toStdString(), std::ios::binary);
-    if (ss.fail()) {
+    // map the input file and find every game boundary in one scan
+    StreamParser parser(file);
+    if (!parser.file()->isOpen()) {
         if (progressBar) progressBar->deleteLater();
         mOpeningsPathLabel->setText(tr("Failed to open file"));
         return;
     }
-
-    // determine total bytes for progress reporting
-    ss.clear();
-    ss.seekg(0, std::ios::end);
-    std::streamoff totalBytesStream = ss.tellg();
-    ss.seekg(0, std::ios::beg);
-    qint64 totalBytes = (totalBytesStream < 0 ? 0 : (qint64)totalBytesStream);
+    const std::vector<PGNSpan> games = parser.findGames();
+    qint64 totalBytes = static_cast<qint64>(parser.file()->view().size());
 
     // create temporary headers blob
     QTemporaryFile tmpHeader;
@@ -331,155 +327,89 @@ void SettingsDialog::importPgnFileStreaming(const QString &file, QProgressBar *p
 
     qint64 parseTime = 0;
 
-    // skip leading BOM/garbage until '['
-    const int EOF_MARK = std::char_traits<char>::eof();
-    int ch;
-    while ((ch = ss.peek()) != EOF_MARK && ch != '[') ss.get();
+    // Games are parsed and replayed on all cores one batch at a time, then merged in file order,
+    // so game ids and the opening maps are the same as with a sequential import
+    struct ParsedGame {
+        PGNGameRecord record;
+        QString bodyText;
+        QVector<quint64> zobristHashes;
+    };
+    const qsizetype BATCH_SIZE = 4096;
+    std::vector<ParsedGame> batch;
 
     quint32 gameIndex = 0;
-    for (;;) {
-        if (!ss.good()) break;
-
-        std::string line;
-        std::string bodyTextStd;
-        QVector<QPair<QString, QString>> headersLocal;
-        QString resultStr;
-
-        // --- Read header lines
-        ch = ss.peek();
-        while (ch != EOF_MARK && ch == '[') {
-            if (!std::getline(ss, line)) break;
-
-            // parse tag and value robustly
-            size_t firstQuote = line.find('"');
-            QString tag, value;
-            if (firstQuote != std::string::npos) {
-                // tag between '[' and just before firstQuote (trim trailing whitespace)
-                size_t tagStart = 1; // skip '['
-                size_t tagEnd = firstQuote;
-                while (tagEnd > tagStart && isspace((unsigned char)line[tagEnd - 1])) --tagEnd;
-                if (tagEnd > tagStart) tag = QString::fromStdString(line.substr(tagStart, tagEnd - tagStart));
-
-                // value between firstQuote and secondQuote
-                size_t secondQuote = line.find('"', firstQuote + 1);
-                if (secondQuote != std::string::npos && secondQuote > firstQuote + 1) {
-                    value = QString::fromStdString(line.substr(firstQuote + 1, secondQuote - firstQuote - 1));
-                }
-            } else {
-                // fallback: line like [Key Value] or malformed — try to trim brackets
-                if (line.size() >= 2 && line.front() == '[' && line.back() == ']') {
-                    std::string inner = line.substr(1, line.size() - 2);
-                    // split by first space
-                    size_t sp = inner.find(' ');
-                    if (sp != std::string::npos) {
-                        tag = QString::fromStdString(inner.substr(0, sp));
-                        value = QString::fromStdString(inner.substr(sp + 1));
-                    } else {
-                        tag = QString::fromStdString(inner);
-                    }
-                }
-            }
-
-            if (!tag.isEmpty() && tag.endsWith(' ')) tag.chop(1);
-            if (tag == "Result") resultStr = value;
-            headersLocal.append(qMakePair(tag, value));
-            ch = ss.peek();
-        }
-
-        // read body text until next header or EOF
-        while (true) {
-            std::streampos pos = ss.tellg();
-            if (!std::getline(ss, line)) {
-                break;
-            }
-            if (isHeaderLine(line)) {
-                ss.clear();
-                ss.seekg(pos);
-                break;
-            }
-            bodyTextStd += line;
-            bodyTextStd.push_back(' ');
-        }
-
-        // if no headers and no body, we are done
-        if (headersLocal.isEmpty() && bodyTextStd.empty()) break;
-
-        // Build PGNGame object for processing
-        PGNGame game;
-        game.headerInfo = headersLocal;
-        game.result = resultStr;
-        game.bodyText = QString::fromStdString(bodyTextStd);
-
-        // record header offset and write header record to tmp blob
-        quint64 relOff = quint64(tmpHeader.pos());
-        headerRelativeOffsets.append(relOff);
-
-        // extract a few canonical header fields for compact record
-        QString white, whiteElo, black, blackElo, event, date;
-        for (const auto &h : game.headerInfo) {
-            if (h.first == "White") white = h.second;
-            else if (h.first == "WhiteElo") whiteElo = h.second;
-            else if (h.first == "Black") black = h.second;
-            else if (h.first == "BlackElo") blackElo = h.second;
-            else if (h.first == "Event") event = h.second;
-            else if (h.first == "Date") date = h.second;
-        }
-
-        tmpOut << white << whiteElo << black << blackElo << event << date << game.result;
-        tmpOut << game.bodyText;
+    for (qsizetype batchStart = 0; batchStart < qsizetype(games.size()); batchStart += BATCH_SIZE) {
+        qsizetype batchEnd = qMin<qsizetype>(games.size(), batchStart + BATCH_SIZE);
+        batch.assign(batchEnd - batchStart, ParsedGame());
 
         QElapsedTimer timer;
         timer.start();
-        parseBodyText(game.bodyText, game.rootMove, true);
+        parallelForChunks(batchEnd - batchStart, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype i = begin; i < end; ++i) {
+                ParsedGame &parsed = batch[i];
+                parsed.record = parser.parseGame(games[batchStart + i]);
+                parsed.bodyText = parser.file()->decode(parsed.record.bodySpan);
+                // collect zobrist hashes along the mainline, no notation tree is needed
+                replayMainline(parser.file()->view(parsed.record.bodySpan), MAX_OPENING_DEPTH, &parsed.zobristHashes);
+            }
+        }, 16);
         parseTime += timer.elapsed();
 
-        // collect zobrist hashes along first-variation/mainline
-        QVector<quint64> zobristHashes;
-        if (!game.rootMove.isNull()) {
-            QSharedPointer<NotationMove> mv = game.rootMove;
-            zobristHashes.push_back(mv->m_zobristHash);
-            while (!mv->m_nextMoves.isEmpty()) {
-                mv = mv->m_nextMoves.front();
-                zobristHashes.push_back(mv->m_zobristHash);
+        for (const ParsedGame &parsed : batch) {
+            const QVector<QPair<QString, QString>> &headersLocal = parsed.record.headerInfo;
+            const QString &resultStr = parsed.record.result;
+            const QVector<quint64> &zobristHashes = parsed.zobristHashes;
+
+            // skip stray text that holds neither headers nor movetext
+            if (headersLocal.isEmpty() && parsed.record.bodySpan.length == 0) continue;
+
+            // record header offset and write header record to tmp blob
+            quint64 relOff = quint64(tmpHeader.pos());
+            headerRelativeOffsets.append(relOff);
+
+            // extract a few canonical header fields for compact record
+            QString white, whiteElo, black, blackElo, event, date;
+            for (const auto &h : headersLocal) {
+                if (h.first == "White") white = h.second;
+                else if (h.first == "WhiteElo") whiteElo = h.second;
+                else if (h.first == "Black") black = h.second;
+                else if (h.first == "BlackElo") blackElo = h.second;
+                else if (h.first == "Event") event = h.second;
+                else if (h.first == "Date") date = h.second;
             }
-        }
 
-        // interpret result
-        enum GameResult { UNKNOWN, WHITE_WIN, BLACK_WIN, DRAW };
-        GameResult gres = UNKNOWN;
-        if (game.result == "1-0") gres = WHITE_WIN;
-        else if (game.result == "0-1") gres = BLACK_WIN;
-        else if (game.result == "1/2-1/2") gres = DRAW;
-
-        // update maps (avoid counting same position twice per game)
-        QSet<quint64> visited;
-        for (int j = 0; j < qMin(MAX_OPENING_DEPTH, zobristHashes.size()); ++j) {
-            quint64 z = zobristHashes[j];
-            if (!visited.contains(z) && openingGameMap[z].size() < MAX_GAMES_TO_SHOW) {
-                openingGameMap[z].push_back(gameIndex);
+            tmpOut << white << whiteElo << black << blackElo << event << date << resultStr;
+            tmpOut << parsed.bodyText;
+
+            // interpret result
+            enum GameResult { UNKNOWN, WHITE_WIN, BLACK_WIN, DRAW };
+            GameResult gres = UNKNOWN;
+            if (resultStr == "1-0") gres = WHITE_WIN;
+            else if (resultStr == "0-1") gres = BLACK_WIN;
+            else if (resultStr == "1/2-1/2") gres = DRAW;
+
+            // update maps (avoid counting same position twice per game)
+            QSet<quint64> visited;
+            for (int j = 0; j < qMin(MAX_OPENING_DEPTH, zobristHashes.size()); ++j) {
+                quint64 z = zobristHashes[j];
+                if (!visited.contains(z) && openingGameMap[z].size() < MAX_GAMES_TO_SHOW) {
+                    openingGameMap[z].push_back(gameIndex);
+                }
+                PositionWinrate &wr = openingWinrateMap[z];
+                if (gres == WHITE_WIN) wr.whiteWin++;
+                else if (gres == BLACK_WIN) wr.blackWin++;
+                else if (gres == DRAW) wr.draw++;
+
+                visited.insert(z);
             }
-            PositionWinrate &wr = openingWinrateMap[z];
-            if (gres == WHITE_WIN) wr.whiteWin++;
-            else if (gres == BLACK_WIN) wr.blackWin++;
-            else if (gres == DRAW) wr.draw++;
 
-            visited.insert(z);
+            ++gameIndex;
         }
 
-        // free heavy structures
-        if (!game.rootMove.isNull()) game.rootMove.clear();
-        game.bodyText.clear();
-        game.headerInfo.clear();
-
         // UI progress update
-        std::streamoff pos = ss.tellg();
-        qint64 readPos = (pos < 0 ? 0 : (qint64)pos);
-        reportProgress(readPos, totalBytes, progressBar);
-
-        ++gameIndex;
-        // loop continues to next game
-        if (ss.eof()) break;
-    } // end for-each-game
+        const PGNSpan &last = games[batchEnd - 1];
+        reportProgress(last.offset + last.length, totalBytes, progressBar);
+    }
 
     // clean up tmp file (we need it closed before finalize)
     tmpHeader.close();
@@ -3,14 +3,16 @@ March 3, 2025: File Creation
 April 20, 2025: Overhauled C++ headers with Qt framework
 */
 
-#include <string>
+#include <cctype>
 #include <QDebug>
 
 #include "streamparser.h"
 #include "pgngame.h"
 #include "chessposition.h"
+#include "compactgame.h"
+#include "parallel.h"
 
-bool isHeaderLine(const std::string &line) {
+bool isHeaderLine(std::string_view line) {
     size_t i = 0;
     while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
     if (i >= line.size()) return false;
@@ -36,83 +38,122 @@ bool isHeaderLine(const std::string &line) {
 }
 
 
-void parseBodyText(QString &bodyText, QSharedPointer<NotationMove> &rootMove, bool openingCutoff){
-    rootMove->m_position->setBoardData(convertFenToBoardData(rootMove->FEN));
-    parseBodyAndBuild(bodyText, rootMove, openingCutoff);
+void parseBodyText(QString &bodyText, NotationMovePtr &rootMove, bool openingCutoff){
+    rootMove->m_position.setBoardData(convertFenToBoardData(rootMove->FEN));
+    // only the packed moves are kept, notation nodes are created as the tree is visited
+    rootMove->loadCompactNode(CompactGame::parse(bodyText, rootMove->m_position.board(), openingCutoff), 0);
 }
 
-std::vector<PGNGame> StreamParser::parseDatabase(){
-    std::vector<PGNGame> database;
-    std::string bufferedLine;
-    bool hasBufferedLine = false;
+// Returns the line starting at pos without its newline and moves pos past it
+static std::string_view nextLine(std::string_view text, size_t &pos)
+{
+    size_t end = text.find('\n', pos);
+    if (end == std::string_view::npos) end = text.size();
+    std::string_view line = text.substr(pos, end - pos);
+    pos = (end < text.size() ? end + 1 : end);
+    return line;
+}
+
+// Cheap test run on every line before the full header check
+static bool startsWithBracket(std::string_view line)
+{
+    size_t i = 0;
+    while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+    return i < line.size() && line[i] == '[';
+}
+
+std::vector<PGNSpan> StreamParser::findGames() const {
+    std::vector<PGNSpan> games;
+    if (!pgnFile->isOpen()) return games;
+
+    const std::string_view text = pgnFile->view();
+    size_t pos = 0;
 
     // Text files contain BOM indicators which should be skipped
-    char c;
-    while ((c = streamBuffer.peek()) != EOF && c != '[') {
-        streamBuffer.get();
+    while (pos < text.size() && text[pos] != '[') pos++;
+    if (pos == text.size()) return games;
+
+    size_t gameStart = pos;
+    bool previousWasHeader = true;
+    while (pos < text.size()){
+        size_t lineStart = pos;
+        std::string_view line = nextLine(text, pos);
+        bool header = startsWithBracket(line) && isHeaderLine(line);
+        if (header && !previousWasHeader){
+            games.push_back({static_cast<qint64>(gameStart), static_cast<qint64>(lineStart - gameStart)});
+            gameStart = lineStart;
+        }
+        previousWasHeader = header;
     }
+    games.push_back({static_cast<qint64>(gameStart), static_cast<qint64>(text.size() - gameStart)});
+    return games;
+}
 
-    // PGN files can have any number of games, continue parsing until end of file
-    while(!streamBuffer.eof()){
-        std::string bodyText;
-        PGNGame game;
-
-        // Get PGN header information which is formatted as [<string> "<string>"]
-        while (streamBuffer.peek() != EOF){
-            QString tag, value;
-            std::string line;
-            if (hasBufferedLine){
-                line = bufferedLine;
-                hasBufferedLine = false;
-            } else {
-                std::getline(streamBuffer, line);
-            }
-            if(!isHeaderLine(line)){
-                break;
-            }
-
-            auto c = line.begin();
-            // Get header tag
-            c++;
-            while (c != line.end() && *c != '"'){
-                tag += *c;
-                c++;
-            }
-
-            // Remove extra whitespace in tag
-            if (!tag.isEmpty() && tag.back() == ' '){
-                tag.chop(1);
-            }
-
-            // Get header value
-            if (c != line.end()) c++;
-            while (c != line.end() && *c != '"'){
-                value += *c;
-                c++;
-            }
-
-            if (tag == "Result"){
-                game.result = value;
-            }
-
-            game.headerInfo.push_back({tag, value});
+PGNGameRecord StreamParser::parseGame(PGNSpan game) const {
+    PGNGameRecord record;
+    const std::string_view text = pgnFile->view(game);
+    size_t pos = 0;
+
+    // Get PGN header information which is formatted as [<string> "<string>"]
+    while (pos < text.size()){
+        size_t lineStart = pos;
+        std::string_view line = nextLine(text, pos);
+        if (!isHeaderLine(line)){
+            // first movetext line
+            pos = lineStart;
+            break;
         }
 
-        // read body text until next header or EOF
-        while (streamBuffer.peek() != EOF){
-            std::string line;
-            std::getline(streamBuffer, line);
-            if (isHeaderLine(line)) {
-                bufferedLine = line;
-                hasBufferedLine = true;
-                break;
-            }
-            bodyText += line + " ";
+        // Get header tag, removing extra whitespace
+        size_t open = line.find('[') + 1;
+        size_t quote = line.find('"', open);
+        size_t tagEnd = quote;
+        if (tagEnd > open && line[tagEnd - 1] == ' ') tagEnd--;
+        QString tag = QString::fromUtf8(line.data() + open, static_cast<qsizetype>(tagEnd - open));
+
+        // Get header value
+        size_t closing = line.find('"', quote + 1);
+        QString value = QString::fromUtf8(line.data() + quote + 1, static_cast<qsizetype>(closing - quote - 1));
+
+        if (tag == "Result"){
+            record.result = value;
         }
 
-        game.bodyText = QString::fromStdString(bodyText);
+        record.headerInfo.push_back({tag, value});
+    }
+
+    // movetext runs to the end of the game and stays in the file for now
+    record.bodySpan = {game.offset + static_cast<qint64>(pos), game.length - static_cast<qint64>(pos)};
+    return record;
+}
+
+std::vector<PGNGameRecord> StreamParser::parseRecords() const {
+    const std::vector<PGNSpan> spans = findGames();
+
+    std::vector<PGNGameRecord> records(spans.size());
+    parallelForChunks(static_cast<qsizetype>(spans.size()), [&](qsizetype begin, qsizetype end) {
+        for (qsizetype i = begin; i < end; ++i) records[i] = parseGame(spans[i]);
+    });
+    return records;
+}
+
+std::vector<PGNGame> StreamParser::buildGames(std::vector<PGNGameRecord> &records) const {
+    // PGNGame owns a notation tree, so the games themselves are built here in file order
+    std::vector<PGNGame> database;
+    database.reserve(records.size());
+    for (PGNGameRecord &record : records){
+        PGNGame game;
+        game.headerInfo = std::move(record.headerInfo);
+        game.result = std::move(record.result);
+        game.source = pgnFile;
+        game.bodySpan = record.bodySpan;
         database.push_back(std::move(game));
     }
 
     return database;
 }
+
+std::vector<PGNGame> StreamParser::parseDatabase(){
+    std::vector<PGNGameRecord> records = parseRecords();
+    return buildGames(records);
+}
@@ -4,21 +4,45 @@ April 20, 2025: Overhauled C++ headers with Qt framework
 */
 
 #include <vector>
-#include <iostream>
-#include <istream>
+#include <string_view>
 
 #include "pgngame.h"
+#include "pgnfile.h"
 
+// Header tags and movetext location of one game. Plain data, so games can be parsed on worker threads
+struct PGNGameRecord {
+    QVector<QPair<QString,QString>> headerInfo;
+    QString result = "*";
+    PGNSpan bodySpan;
+    // Mainline length, counted by the importer
+    int plyCount = 0;
+};
+
+// Splits a PGN file into games over its memory mapping in two phases: a sequential scan for game
+// boundaries, then header parsing of chunks of games on a thread pool. Headers are decoded,
+// movetext is only recorded as a span and decoded when a game is opened
 class StreamParser
 {
 
 public:
-    explicit StreamParser(std::istream &stream) : streamBuffer(stream) {}
+    explicit StreamParser(const QString &path) : pgnFile(QSharedPointer<PGNFile>::create(path)) {}
     std::vector<PGNGame> parseDatabase();
+
+    // Header parsing of every game, see parseDatabase()
+    std::vector<PGNGameRecord> parseRecords() const;
+    // Games of records in file order, their movetext read from this parser's file
+    std::vector<PGNGame> buildGames(std::vector<PGNGameRecord> &records) const;
+
+    // Byte ranges of every game in file order; a game starts at a header line that follows movetext
+    std::vector<PGNSpan> findGames() const;
+    // Parses one game found by findGames(); safe to call from several threads at once
+    PGNGameRecord parseGame(PGNSpan game) const;
+
+    const QSharedPointer<PGNFile>& file() const { return pgnFile; }
     
 private:
-    std::istream &streamBuffer;
+    QSharedPointer<PGNFile> pgnFile;
 };
 
-void parseBodyText(QString &bodyText, QSharedPointer<NotationMove> &rootMove, bool openingCutoff = false);
-bool isHeaderLine(const std::string &line);
+void parseBodyText(QString &bodyText, NotationMovePtr &rootMove, bool openingCutoff = false);
+bool isHeaderLine(std::string_view line);
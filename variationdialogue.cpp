@@ -24,10 +24,10 @@ VariationDialogue::VariationDialogue(QWidget* parent) : QDialog(parent) {
     });
 }
 
-void VariationDialogue::setVariations(const QSharedPointer<NotationMove>& currentMove) {
+void VariationDialogue::setVariations(const NotationMovePtr& currentMove) {
     listWidget->clear();
 
-    for (const auto& move : currentMove->m_nextMoves) {
+    for (const auto& move : currentMove->nextMoves()) {
         listWidget->addItem(move->moveText);
         m_moves.append(move);
     }
@@ -37,7 +37,7 @@ void VariationDialogue::setVariations(const QSharedPointer<NotationMove>& curren
     }
 }
 
-QSharedPointer<NotationMove> VariationDialogue::selectedMove() const {
+NotationMovePtr VariationDialogue::selectedMove() const {
     if (m_selectedIndex >= 0 && m_selectedIndex < m_moves.size()) {
         return m_moves[m_selectedIndex];
     }
@@ -16,15 +16,15 @@ class VariationDialogue : public QDialog
 public:
     VariationDialogue(QWidget* parent = nullptr);
 
-    void setVariations(const QSharedPointer<NotationMove>& currentMove);
-    QSharedPointer<NotationMove> selectedMove() const;
+    void setVariations(const NotationMovePtr& currentMove);
+    NotationMovePtr selectedMove() const;
 
 protected:
     void keyPressEvent(QKeyEvent* event) override;
 
 private:
     QListWidget* listWidget;
-    QList<QSharedPointer<NotationMove>> m_moves;
+    QList<NotationMovePtr> m_moves;
     int m_selectedIndex = -1;
 };
 